@@ -0,0 +1,124 @@
+#ifndef APU_H
+#define APU_H
+
+#include <stdint.h>
+#include "blip.h"
+
+struct nes_memory_t;
+
+// APU (2A03): 2 pulsos, triângulo, ruído, DMC e frame counter.
+//
+// Como a PPU, a APU só anda quando precisa: num acesso a $4000-$4017,
+// num IRQ previsto (apu_next_event) e no fim do frame. Cada catch-up
+// avança os timers de canal em canal, de um clock de timer ao próximo
+// (não ciclo a ciclo), e cada mudança na saída mixada vira um degrau no
+// blip buffer, que gera as amostras já com banda limitada.
+
+#define APU_SAMPLE_RATE    48000     // padrão (44100 também funciona)
+#define APU_MAX_SAMPLES    2048      // amostras por frame (com folga)
+
+typedef struct {
+    uint8_t start;      // reinicia no próximo quarter frame
+    uint8_t loop;       // = halt do length counter
+    uint8_t constant;   // 1 = volume constante
+    uint8_t volume;     // volume constante / período do divisor
+    uint8_t divider;
+    uint8_t decay;      // 15..0
+} apu_envelope_t;
+
+typedef struct {
+    apu_envelope_t env;
+    uint8_t  duty, step;
+    uint8_t  length;
+    uint8_t  sweep_enabled, sweep_period, sweep_negate, sweep_shift;
+    uint8_t  sweep_reload, sweep_divider;
+    uint8_t  ones_complement; // pulso 1: negate subtrai período + 1
+    uint16_t period;          // timer de 11 bits
+    uint64_t next;            // ciclo de CPU do próximo clock do timer
+} apu_pulse_t;
+
+typedef struct {
+    uint8_t  control;         // halt do length + controle do linear counter
+    uint8_t  length;
+    uint8_t  linear, linear_load, linear_reload;
+    uint8_t  step;            // 0-31
+    uint16_t period;
+    uint64_t next;
+} apu_triangle_t;
+
+typedef struct {
+    apu_envelope_t env;
+    uint8_t  mode;            // 1 = sequência curta (bit 6)
+    uint8_t  length;
+    uint16_t lfsr;
+    uint16_t period;          // em ciclos de CPU
+    uint64_t next;
+} apu_noise_t;
+
+typedef struct {
+    uint8_t  irq_enable, loop;
+    uint8_t  level;           // saída de 7 bits
+    uint16_t period;          // em ciclos de CPU
+    uint16_t sample_addr, sample_length;
+    uint16_t addr, remaining; // leitura em curso
+    uint8_t  buffer, buffer_full;
+    uint8_t  shift, bits, silence;
+    uint64_t next;
+} apu_dmc_t;
+
+typedef struct nes_apu_t {
+    // De pulse até frame_start: estado salvo em bloco (state.c)
+    apu_pulse_t    pulse[2];
+    apu_triangle_t triangle;
+    apu_noise_t    noise;
+    apu_dmc_t      dmc;
+    uint8_t        enabled;   // $4015 bits 0-3 (length counters liberados)
+
+    // Frame counter ($4017)
+    uint8_t  frame_mode;      // 0 = 4 passos, 1 = 5 passos
+    uint8_t  irq_inhibit;
+    uint8_t  frame_irq, dmc_irq;
+    int      frame_step;
+    uint64_t frame_base;      // ciclo em que a sequência atual começou
+    uint64_t frame_next;      // ciclo do próximo passo
+
+    // Mixer: saída atual de cada canal e amplitude já mixada
+    uint8_t  out[5];
+    int      amp;
+
+    uint64_t cpu_time;        // ciclo de CPU até onde a APU já foi emulada
+    uint64_t frame_start;     // ciclo do início do frame de áudio atual
+
+    struct nes_memory_t *mem; // leituras do DMC e linha de IRQ da CPU
+    nes_blip_t *blip;
+    int sample_rate;
+
+    // Amostras do último frame (mono, 16 bits)
+    int16_t samples[APU_MAX_SAMPLES];
+    int     sample_count;
+} nes_apu_t;
+
+nes_apu_t* apu_init(struct nes_memory_t *mem, int sample_rate);
+void apu_free(nes_apu_t *apu);
+
+// Troca a taxa de saída (ex.: a que o backend de áudio conseguiu abrir)
+int apu_set_sample_rate(nes_apu_t *apu, int sample_rate);
+
+// Ajuste fino da taxa (ex.: 1.002 = 0,2% mais amostras por frame), vindo
+// do controle dinâmico de taxa do backend de áudio
+void apu_set_rate_ratio(nes_apu_t *apu, double ratio);
+
+uint8_t apu_read(nes_apu_t *apu, uint16_t addr);   // $4015
+void    apu_write(nes_apu_t *apu, uint16_t addr, uint8_t value);
+
+// Emula a APU até o ciclo de CPU cpu_cycle
+void apu_catch_up(nes_apu_t *apu, uint64_t cpu_cycle);
+
+// Ciclo de CPU do próximo IRQ da APU (frame counter / fim de amostra do
+// DMC); UINT64_MAX se nenhum estiver para acontecer
+uint64_t apu_next_event(nes_apu_t *apu);
+
+// Fim de frame: alcança cpu_cycle e deixa as amostras em apu->samples
+void apu_end_frame(nes_apu_t *apu, uint64_t cpu_cycle);
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+// ======================
+// Ring SPSC de amostras
+// ======================
+// Um produtor (emulação) e um consumidor (callback do backend), sem
+// lock e sem espera: cada lado só escreve no próprio índice. Capacidade
+// potência de 2; os índices crescem livremente e são mascarados.
+typedef struct {
+    int16_t *data;
+    uint32_t mask;
+    _Atomic uint32_t head;   // próxima escrita (produtor)
+    _Atomic uint32_t tail;   // próxima leitura (consumidor)
+} nes_audio_ring_t;
+
+int  audio_ring_init(nes_audio_ring_t *ring, uint32_t capacity);
+void audio_ring_free(nes_audio_ring_t *ring);
+// Retornam quantas amostras couberam / foram lidas
+int  audio_ring_write(nes_audio_ring_t *ring, const int16_t *samples, int count);
+int  audio_ring_read(nes_audio_ring_t *ring, int16_t *out, int count);
+int  audio_ring_count(nes_audio_ring_t *ring);
+
+// ======================
+// Saída de áudio
+// ======================
+// Mesmo modelo do vídeo (video.h): a APU entrega as amostras do frame e
+// o backend toca. Backends com relógio próprio (queued != NULL) também
+// ditam o ritmo da emulação: audio_wait dorme enquanto o buffer estiver
+// acima do alvo, e audio_rate_ratio ajusta levemente a taxa de amostras
+// (dynamic rate control) para o buffer ficar no meio.
+typedef struct nes_audio_sink_t {
+    const char *name;
+    int  (*init)(struct nes_audio_sink_t *sink);                                     // 1 = ok
+    void (*write)(struct nes_audio_sink_t *sink, const int16_t *samples, int count);
+    int  (*queued)(struct nes_audio_sink_t *sink);   // amostras ainda não tocadas (pode ser NULL)
+    void (*shutdown)(struct nes_audio_sink_t *sink);
+    int sample_rate;        // pedida antes do init; a real depois dele
+    int buffer_samples;     // latência máxima; o alvo é a metade
+    void *ctx;              // estado do backend
+} nes_audio_sink_t;
+
+// --- Backends ---
+nes_audio_sink_t* audio_null_create(int sample_rate);
+nes_audio_sink_t* audio_file_create(const char *path, int sample_rate);  // WAV mono 16 bits
+#ifndef NES_HEADLESS
+nes_audio_sink_t* audio_sdl_create(int sample_rate);                     // SDL (audio_sdl.c)
+#endif
+
+// Cria a partir de uma string: "sdl", "null", "file:<path.wav>"
+nes_audio_sink_t* audio_create(const char *spec, int sample_rate);
+
+// --- API ---
+int    audio_init(nes_audio_sink_t *sink);
+void   audio_write(nes_audio_sink_t *sink, const int16_t *samples, int count);
+void   audio_wait(nes_audio_sink_t *sink);
+double audio_rate_ratio(nes_audio_sink_t *sink);
+void   audio_free(nes_audio_sink_t *sink);
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef BLIP_H
+#define BLIP_H
+
+#include <stdint.h>
+
+// Síntese de degraus com banda limitada ("blip buffer").
+//
+// Quem gera o som não produz amostras: só avisa "a saída mudou de X no
+// clock T" (blip_add_delta). Cada degrau é somado ao buffer já filtrado
+// (um kernel de sinc janelado com a fase fracionária do clock), e as
+// amostras saem integrando o buffer. O custo depende do número de
+// mudanças da saída, não do número de clocks da CPU.
+
+#define BLIP_PHASE_BITS  5
+#define BLIP_PHASES      (1 << BLIP_PHASE_BITS)
+#define BLIP_TAPS        16
+#define BLIP_KERNEL_BITS 14   // soma dos taps de cada fase = 1 << 14
+
+typedef struct {
+    uint64_t factor;     // amostras por clock (ponto fixo 32.32)
+    uint64_t offset;     // posição (32.32) do início do frame atual em buf
+    int      size;       // capacidade em amostras
+    int      avail;      // amostras completas prontas para leitura
+    int32_t  integrator; // soma corrente dos deltas (saída antes do filtro DC)
+    int32_t  dc;         // nível DC estimado (24.8) para o passa-alta
+    int32_t *buf;        // size + BLIP_TAPS entradas
+    int16_t  kernel[BLIP_PHASES][BLIP_TAPS];
+} nes_blip_t;
+
+// clock_rate e sample_rate em Hz; max_samples = amostras por frame (com folga)
+nes_blip_t* blip_new(double clock_rate, int sample_rate, int max_samples);
+void blip_free(nes_blip_t *b);
+void blip_clear(nes_blip_t *b);
+
+// Troca a razão clock/amostra sem perder o que está no buffer (chamar
+// entre frames; usado pelo controle dinâmico de taxa)
+void blip_set_rates(nes_blip_t *b, double clock_rate, double sample_rate);
+
+// Degrau de amplitude delta no clock time (relativo ao início do frame)
+static inline void blip_add_delta(nes_blip_t *b, uint32_t time, int delta) {
+    uint64_t pos = b->offset + (uint64_t)time * b->factor;
+    int32_t *out = b->buf + (pos >> 32);
+    const int16_t *k = b->kernel[(pos >> (32 - BLIP_PHASE_BITS)) & (BLIP_PHASES - 1)];
+    for (int i = 0; i < BLIP_TAPS; i++) out[i] += k[i] * delta;
+}
+
+// Fecha o frame de clocks clocks: as amostras até ali ficam disponíveis.
+// Quem chama lê as amostras antes de passar de max_samples pendentes.
+void blip_end_frame(nes_blip_t *b, uint32_t clocks);
+
+// Lê até count amostras (mono, 16 bits); retorna quantas leu
+int blip_read_samples(nes_blip_t *b, int16_t *out, int count);
+
+#endif
@@ -33,14 +33,25 @@ typedef enum {
 
 // --- Estrutura CPU ---
 typedef struct nes_cpu_t {
+    struct nes_memory_t *memory; // ponteiro pra memória
+    uint64_t run_until;   // fim do lote atual de cpu_run (0 = parar já); transitório, fora do save
+    uint8_t opcode;       // instrução em execução (ciclo dos acessos a I/O); idem
+
+    // De a até irq_line: estado salvo em bloco (state.c)
     uint8_t a, x, y;      // registradores
     uint8_t sp;           // stack pointer
     uint16_t pc;          // program counter
     uint8_t status;       // status flags
-    struct nes_memory_t *memory; // ponteiro pra memória
-    
+
+    uint64_t cycles;      // ciclos executados desde o power-on
+    int nmi_pending;      // NMI sinalizada (PPU), atendida antes da próxima instrução
+    uint8_t irq_line;     // fontes de IRQ ativas (CPU_IRQ_*), nível
 } nes_cpu_t;
 
+// Fontes da linha de IRQ
+#define CPU_IRQ_MAPPER 0x01
+#define CPU_IRQ_APU    0x02
+
 // --- Estrutura de instruções ---
 typedef struct {
     const char *name;
@@ -48,6 +59,10 @@ typedef struct {
     uint8_t bytes;
     uint8_t cycles;
     void (*execute)(nes_cpu_t *cpu, addr_mode_t mode);
+    // Ciclo (a partir de 0) da leitura/escrita do operando: o último,
+    // exceto a leitura dos read-modify-write (3 antes do fim). Usado
+    // para alcançar PPU/APU no ciclo exato do acesso (memory.c)
+    uint8_t read_cycle, write_cycle;
 } instruction_t;
 
 extern instruction_t instructions[256];
@@ -58,6 +73,31 @@ void cpu_free(nes_cpu_t *cpu);
 void cpu_reset(nes_cpu_t *cpu);
 int cpu_step(nes_cpu_t *cpu);
 void cpu_nmi(nes_cpu_t *cpu);
+void cpu_irq(nes_cpu_t *cpu);
+
+// Liga/desliga uma fonte da linha de IRQ (atendida se a flag I estiver limpa)
+static inline void cpu_set_irq(nes_cpu_t *cpu, uint8_t source, int active) {
+    if (active) cpu->irq_line |= source;
+    else cpu->irq_line &= ~source;
+}
+
+// Encerra o lote atual depois da instrução em curso (eventos previstos
+// mudaram, ex.: registrador de IRQ do mapper)
+static inline void cpu_yield(nes_cpu_t *cpu) {
+    cpu->run_until = 0;
+}
+
+// Executa instruções em lote até gastar budget_cycles ciclos (ou até
+// cpu_yield); interrupções pendentes são atendidas dentro do lote.
+// Retorna os ciclos realmente executados (pode passar do budget pela
+// duração da última instrução)
+int cpu_run(nes_cpu_t *cpu, int budget_cycles);
+
+#ifdef NES_CPU_GOTO
+// Núcleo com computed goto (cpu_goto.c): roda até cpu->cycles chegar
+// a cpu->run_until ou surgir uma interrupção a atender
+void cpu_exec_goto(nes_cpu_t *cpu);
+#endif
 
 // Inicializa a tabela de instruções
 void init_instructions(void);
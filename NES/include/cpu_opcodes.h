@@ -0,0 +1,336 @@
+#ifndef CPU_OPCODES_H
+#define CPU_OPCODES_H
+
+// Lista única dos 256 opcodes (X-macro): os 151 oficiais e os não
+// oficiais, então a tabela de despacho não tem buracos. Cada entrada:
+//   OP(opcode, MNEMÔNICO, função op_xxx, modo, bytes, ciclos)
+// Usada para montar instructions[] (cpu_instructions.c) e os handlers
+// do núcleo com computed goto (cpu_goto.c).
+#define CPU_OPCODES(OP) \
+    /* === LOAD/STORE === */ \
+    OP(0xA9, LDA, lda, IMMEDIATE,   2, 2) \
+    OP(0xA5, LDA, lda, ZERO_PAGE,   2, 3) \
+    OP(0xB5, LDA, lda, ZERO_PAGE_X, 2, 4) \
+    OP(0xAD, LDA, lda, ABSOLUTE,    3, 4) \
+    OP(0xBD, LDA, lda, ABSOLUTE_X,  3, 4) \
+    OP(0xB9, LDA, lda, ABSOLUTE_Y,  3, 4) \
+    OP(0xA1, LDA, lda, INDIRECT_X,  2, 6) \
+    OP(0xB1, LDA, lda, INDIRECT_Y,  2, 5) \
+    \
+    OP(0xA2, LDX, ldx, IMMEDIATE,   2, 2) \
+    OP(0xA6, LDX, ldx, ZERO_PAGE,   2, 3) \
+    OP(0xB6, LDX, ldx, ZERO_PAGE_Y, 2, 4) \
+    OP(0xAE, LDX, ldx, ABSOLUTE,    3, 4) \
+    OP(0xBE, LDX, ldx, ABSOLUTE_Y,  3, 4) \
+    \
+    OP(0xA0, LDY, ldy, IMMEDIATE,   2, 2) \
+    OP(0xA4, LDY, ldy, ZERO_PAGE,   2, 3) \
+    OP(0xB4, LDY, ldy, ZERO_PAGE_X, 2, 4) \
+    OP(0xAC, LDY, ldy, ABSOLUTE,    3, 4) \
+    OP(0xBC, LDY, ldy, ABSOLUTE_X,  3, 4) \
+    \
+    OP(0x85, STA, sta, ZERO_PAGE,   2, 3) \
+    OP(0x95, STA, sta, ZERO_PAGE_X, 2, 4) \
+    OP(0x8D, STA, sta, ABSOLUTE,    3, 4) \
+    OP(0x9D, STA, sta, ABSOLUTE_X,  3, 5) \
+    OP(0x99, STA, sta, ABSOLUTE_Y,  3, 5) \
+    OP(0x81, STA, sta, INDIRECT_X,  2, 6) \
+    OP(0x91, STA, sta, INDIRECT_Y,  2, 6) \
+    \
+    OP(0x86, STX, stx, ZERO_PAGE,   2, 3) \
+    OP(0x96, STX, stx, ZERO_PAGE_Y, 2, 4) \
+    OP(0x8E, STX, stx, ABSOLUTE,    3, 4) \
+    \
+    OP(0x84, STY, sty, ZERO_PAGE,   2, 3) \
+    OP(0x94, STY, sty, ZERO_PAGE_X, 2, 4) \
+    OP(0x8C, STY, sty, ABSOLUTE,    3, 4) \
+    \
+    /* === TRANSFER === */ \
+    OP(0xAA, TAX, tax, IMPLIED,     1, 2) \
+    OP(0xA8, TAY, tay, IMPLIED,     1, 2) \
+    OP(0x8A, TXA, txa, IMPLIED,     1, 2) \
+    OP(0x98, TYA, tya, IMPLIED,     1, 2) \
+    OP(0xBA, TSX, tsx, IMPLIED,     1, 2) \
+    OP(0x9A, TXS, txs, IMPLIED,     1, 2) \
+    \
+    /* === JUMPS === */ \
+    OP(0x4C, JMP, jmp, ABSOLUTE,    3, 3) \
+    OP(0x6C, JMP, jmp, INDIRECT,    3, 5) \
+    OP(0x20, JSR, jsr, ABSOLUTE,    3, 6) \
+    OP(0x60, RTS, rts, IMPLIED,     1, 6) \
+    \
+    /* === INTERRUPTS === */ \
+    OP(0x00, BRK, brk, IMPLIED,     1, 7) \
+    OP(0x40, RTI, rti, IMPLIED,     1, 6) \
+    \
+    /* === BRANCHES === */ \
+    OP(0x10, BPL, bpl, RELATIVE,    2, 2) \
+    OP(0x30, BMI, bmi, RELATIVE,    2, 2) \
+    OP(0x50, BVC, bvc, RELATIVE,    2, 2) \
+    OP(0x70, BVS, bvs, RELATIVE,    2, 2) \
+    OP(0x90, BCC, bcc, RELATIVE,    2, 2) \
+    OP(0xB0, BCS, bcs, RELATIVE,    2, 2) \
+    OP(0xD0, BNE, bne, RELATIVE,    2, 2) \
+    OP(0xF0, BEQ, beq, RELATIVE,    2, 2) \
+    \
+    /* === FLAGS === */ \
+    OP(0xD8, CLD, cld, IMPLIED,     1, 2) \
+    OP(0x58, CLI, cli, IMPLIED,     1, 2) \
+    OP(0xB8, CLV, clv, IMPLIED,     1, 2) \
+    OP(0x18, CLC, clc, IMPLIED,     1, 2) \
+    OP(0xF8, SED, sed, IMPLIED,     1, 2) \
+    OP(0x78, SEI, sei, IMPLIED,     1, 2) \
+    OP(0x38, SEC, sec, IMPLIED,     1, 2) \
+    \
+    /* === MISC === */ \
+    OP(0xEA, NOP, nop, IMPLIED,     1, 2) \
+    \
+    /* === ARITHMETIC === */ \
+    OP(0x69, ADC, adc, IMMEDIATE,   2, 2) \
+    OP(0x65, ADC, adc, ZERO_PAGE,   2, 3) \
+    OP(0x75, ADC, adc, ZERO_PAGE_X, 2, 4) \
+    OP(0x6D, ADC, adc, ABSOLUTE,    3, 4) \
+    OP(0x7D, ADC, adc, ABSOLUTE_X,  3, 4) \
+    OP(0x79, ADC, adc, ABSOLUTE_Y,  3, 4) \
+    OP(0x61, ADC, adc, INDIRECT_X,  2, 6) \
+    OP(0x71, ADC, adc, INDIRECT_Y,  2, 5) \
+    \
+    OP(0xE9, SBC, sbc, IMMEDIATE,   2, 2) \
+    OP(0xE5, SBC, sbc, ZERO_PAGE,   2, 3) \
+    OP(0xF5, SBC, sbc, ZERO_PAGE_X, 2, 4) \
+    OP(0xED, SBC, sbc, ABSOLUTE,    3, 4) \
+    OP(0xFD, SBC, sbc, ABSOLUTE_X,  3, 4) \
+    OP(0xF9, SBC, sbc, ABSOLUTE_Y,  3, 4) \
+    OP(0xE1, SBC, sbc, INDIRECT_X,  2, 6) \
+    OP(0xF1, SBC, sbc, INDIRECT_Y,  2, 5) \
+    \
+    /* === LOGICAL === */ \
+    OP(0x29, AND, and, IMMEDIATE,   2, 2) \
+    OP(0x25, AND, and, ZERO_PAGE,   2, 3) \
+    OP(0x35, AND, and, ZERO_PAGE_X, 2, 4) \
+    OP(0x2D, AND, and, ABSOLUTE,    3, 4) \
+    OP(0x3D, AND, and, ABSOLUTE_X,  3, 4) \
+    OP(0x39, AND, and, ABSOLUTE_Y,  3, 4) \
+    OP(0x21, AND, and, INDIRECT_X,  2, 6) \
+    OP(0x31, AND, and, INDIRECT_Y,  2, 5) \
+    \
+    OP(0x09, ORA, ora, IMMEDIATE,   2, 2) \
+    OP(0x05, ORA, ora, ZERO_PAGE,   2, 3) \
+    OP(0x15, ORA, ora, ZERO_PAGE_X, 2, 4) \
+    OP(0x0D, ORA, ora, ABSOLUTE,    3, 4) \
+    OP(0x1D, ORA, ora, ABSOLUTE_X,  3, 4) \
+    OP(0x19, ORA, ora, ABSOLUTE_Y,  3, 4) \
+    OP(0x01, ORA, ora, INDIRECT_X,  2, 6) \
+    OP(0x11, ORA, ora, INDIRECT_Y,  2, 5) \
+    \
+    OP(0x49, EOR, eor, IMMEDIATE,   2, 2) \
+    OP(0x45, EOR, eor, ZERO_PAGE,   2, 3) \
+    OP(0x55, EOR, eor, ZERO_PAGE_X, 2, 4) \
+    OP(0x4D, EOR, eor, ABSOLUTE,    3, 4) \
+    OP(0x5D, EOR, eor, ABSOLUTE_X,  3, 4) \
+    OP(0x59, EOR, eor, ABSOLUTE_Y,  3, 4) \
+    OP(0x41, EOR, eor, INDIRECT_X,  2, 6) \
+    OP(0x51, EOR, eor, INDIRECT_Y,  2, 5) \
+    \
+    /* === COMPARE === */ \
+    OP(0xC9, CMP, cmp, IMMEDIATE,   2, 2) \
+    OP(0xC5, CMP, cmp, ZERO_PAGE,   2, 3) \
+    OP(0xD5, CMP, cmp, ZERO_PAGE_X, 2, 4) \
+    OP(0xCD, CMP, cmp, ABSOLUTE,    3, 4) \
+    OP(0xDD, CMP, cmp, ABSOLUTE_X,  3, 4) \
+    OP(0xD9, CMP, cmp, ABSOLUTE_Y,  3, 4) \
+    OP(0xC1, CMP, cmp, INDIRECT_X,  2, 6) \
+    OP(0xD1, CMP, cmp, INDIRECT_Y,  2, 5) \
+    \
+    OP(0xE0, CPX, cpx, IMMEDIATE,   2, 2) \
+    OP(0xE4, CPX, cpx, ZERO_PAGE,   2, 3) \
+    OP(0xEC, CPX, cpx, ABSOLUTE,    3, 4) \
+    \
+    OP(0xC0, CPY, cpy, IMMEDIATE,   2, 2) \
+    OP(0xC4, CPY, cpy, ZERO_PAGE,   2, 3) \
+    OP(0xCC, CPY, cpy, ABSOLUTE,    3, 4) \
+    \
+    /* === INCREMENT/DECREMENT === */ \
+    OP(0xE6, INC, inc, ZERO_PAGE,   2, 5) \
+    OP(0xF6, INC, inc, ZERO_PAGE_X, 2, 6) \
+    OP(0xEE, INC, inc, ABSOLUTE,    3, 6) \
+    OP(0xFE, INC, inc, ABSOLUTE_X,  3, 7) \
+    \
+    OP(0xE8, INX, inx, IMPLIED,     1, 2) \
+    OP(0xC8, INY, iny, IMPLIED,     1, 2) \
+    \
+    OP(0xC6, DEC, dec, ZERO_PAGE,   2, 5) \
+    OP(0xD6, DEC, dec, ZERO_PAGE_X, 2, 6) \
+    OP(0xCE, DEC, dec, ABSOLUTE,    3, 6) \
+    OP(0xDE, DEC, dec, ABSOLUTE_X,  3, 7) \
+    \
+    OP(0xCA, DEX, dex, IMPLIED,     1, 2) \
+    OP(0x88, DEY, dey, IMPLIED,     1, 2) \
+    \
+    /* === SHIFTS === */ \
+    OP(0x0A, ASL, asl, ACCUMULATOR, 1, 2) \
+    OP(0x06, ASL, asl, ZERO_PAGE,   2, 5) \
+    OP(0x16, ASL, asl, ZERO_PAGE_X, 2, 6) \
+    OP(0x0E, ASL, asl, ABSOLUTE,    3, 6) \
+    OP(0x1E, ASL, asl, ABSOLUTE_X,  3, 7) \
+    \
+    OP(0x4A, LSR, lsr, ACCUMULATOR, 1, 2) \
+    OP(0x46, LSR, lsr, ZERO_PAGE,   2, 5) \
+    OP(0x56, LSR, lsr, ZERO_PAGE_X, 2, 6) \
+    OP(0x4E, LSR, lsr, ABSOLUTE,    3, 6) \
+    OP(0x5E, LSR, lsr, ABSOLUTE_X,  3, 7) \
+    \
+    OP(0x2A, ROL, rol, ACCUMULATOR, 1, 2) \
+    OP(0x26, ROL, rol, ZERO_PAGE,   2, 5) \
+    OP(0x36, ROL, rol, ZERO_PAGE_X, 2, 6) \
+    OP(0x2E, ROL, rol, ABSOLUTE,    3, 6) \
+    OP(0x3E, ROL, rol, ABSOLUTE_X,  3, 7) \
+    \
+    OP(0x6A, ROR, ror, ACCUMULATOR, 1, 2) \
+    OP(0x66, ROR, ror, ZERO_PAGE,   2, 5) \
+    OP(0x76, ROR, ror, ZERO_PAGE_X, 2, 6) \
+    OP(0x6E, ROR, ror, ABSOLUTE,    3, 6) \
+    OP(0x7E, ROR, ror, ABSOLUTE_X,  3, 7) \
+    \
+    /* === STACK === */ \
+    OP(0x48, PHA, pha, IMPLIED,     1, 3) \
+    OP(0x68, PLA, pla, IMPLIED,     1, 4) \
+    OP(0x08, PHP, php, IMPLIED,     1, 3) \
+    OP(0x28, PLP, plp, IMPLIED,     1, 4) \
+    \
+    /* === BIT TEST === */ \
+    OP(0x24, BIT, bit, ZERO_PAGE,   2, 3) \
+    OP(0x2C, BIT, bit, ABSOLUTE,    3, 4) \
+    \
+    CPU_OPCODES_UNOFFICIAL(OP)
+
+// Opcodes não oficiais. Os estáveis (LAX, SAX, DCP, ISC, SLO, RLA, SRE,
+// RRA, ANC, ALR, ARR, AXS e os NOPs com operando) seguem o hardware; os
+// instáveis (XAA, LAX #, AHX, SHY, SHX, TAS) usam o comportamento mais
+// comum e JAM trava a CPU no próprio opcode, como no chip real.
+#define CPU_OPCODES_UNOFFICIAL(OP) \
+    /* === NOP === */ \
+    OP(0x1A, NOP, nop, IMPLIED,     1, 2) \
+    OP(0x3A, NOP, nop, IMPLIED,     1, 2) \
+    OP(0x5A, NOP, nop, IMPLIED,     1, 2) \
+    OP(0x7A, NOP, nop, IMPLIED,     1, 2) \
+    OP(0xDA, NOP, nop, IMPLIED,     1, 2) \
+    OP(0xFA, NOP, nop, IMPLIED,     1, 2) \
+    OP(0x80, NOP, nop, IMMEDIATE,   2, 2) \
+    OP(0x82, NOP, nop, IMMEDIATE,   2, 2) \
+    OP(0x89, NOP, nop, IMMEDIATE,   2, 2) \
+    OP(0xC2, NOP, nop, IMMEDIATE,   2, 2) \
+    OP(0xE2, NOP, nop, IMMEDIATE,   2, 2) \
+    OP(0x04, NOP, nop, ZERO_PAGE,   2, 3) \
+    OP(0x44, NOP, nop, ZERO_PAGE,   2, 3) \
+    OP(0x64, NOP, nop, ZERO_PAGE,   2, 3) \
+    OP(0x14, NOP, nop, ZERO_PAGE_X, 2, 4) \
+    OP(0x34, NOP, nop, ZERO_PAGE_X, 2, 4) \
+    OP(0x54, NOP, nop, ZERO_PAGE_X, 2, 4) \
+    OP(0x74, NOP, nop, ZERO_PAGE_X, 2, 4) \
+    OP(0xD4, NOP, nop, ZERO_PAGE_X, 2, 4) \
+    OP(0xF4, NOP, nop, ZERO_PAGE_X, 2, 4) \
+    OP(0x0C, NOP, nop, ABSOLUTE,    3, 4) \
+    OP(0x1C, NOP, nop, ABSOLUTE_X,  3, 4) \
+    OP(0x3C, NOP, nop, ABSOLUTE_X,  3, 4) \
+    OP(0x5C, NOP, nop, ABSOLUTE_X,  3, 4) \
+    OP(0x7C, NOP, nop, ABSOLUTE_X,  3, 4) \
+    OP(0xDC, NOP, nop, ABSOLUTE_X,  3, 4) \
+    OP(0xFC, NOP, nop, ABSOLUTE_X,  3, 4) \
+    \
+    /* === LOAD/STORE COMBINADOS === */ \
+    OP(0xA7, LAX, lax, ZERO_PAGE,   2, 3) \
+    OP(0xB7, LAX, lax, ZERO_PAGE_Y, 2, 4) \
+    OP(0xAF, LAX, lax, ABSOLUTE,    3, 4) \
+    OP(0xBF, LAX, lax, ABSOLUTE_Y,  3, 4) \
+    OP(0xA3, LAX, lax, INDIRECT_X,  2, 6) \
+    OP(0xB3, LAX, lax, INDIRECT_Y,  2, 5) \
+    OP(0xAB, LAX, lax, IMMEDIATE,   2, 2) \
+    \
+    OP(0x87, SAX, sax, ZERO_PAGE,   2, 3) \
+    OP(0x97, SAX, sax, ZERO_PAGE_Y, 2, 4) \
+    OP(0x8F, SAX, sax, ABSOLUTE,    3, 4) \
+    OP(0x83, SAX, sax, INDIRECT_X,  2, 6) \
+    \
+    OP(0xBB, LAS, las, ABSOLUTE_Y,  3, 4) \
+    \
+    /* === READ-MODIFY-WRITE + ALU === */ \
+    OP(0xC7, DCP, dcp, ZERO_PAGE,   2, 5) \
+    OP(0xD7, DCP, dcp, ZERO_PAGE_X, 2, 6) \
+    OP(0xCF, DCP, dcp, ABSOLUTE,    3, 6) \
+    OP(0xDF, DCP, dcp, ABSOLUTE_X,  3, 7) \
+    OP(0xDB, DCP, dcp, ABSOLUTE_Y,  3, 7) \
+    OP(0xC3, DCP, dcp, INDIRECT_X,  2, 8) \
+    OP(0xD3, DCP, dcp, INDIRECT_Y,  2, 8) \
+    \
+    OP(0xE7, ISC, isc, ZERO_PAGE,   2, 5) \
+    OP(0xF7, ISC, isc, ZERO_PAGE_X, 2, 6) \
+    OP(0xEF, ISC, isc, ABSOLUTE,    3, 6) \
+    OP(0xFF, ISC, isc, ABSOLUTE_X,  3, 7) \
+    OP(0xFB, ISC, isc, ABSOLUTE_Y,  3, 7) \
+    OP(0xE3, ISC, isc, INDIRECT_X,  2, 8) \
+    OP(0xF3, ISC, isc, INDIRECT_Y,  2, 8) \
+    \
+    OP(0x07, SLO, slo, ZERO_PAGE,   2, 5) \
+    OP(0x17, SLO, slo, ZERO_PAGE_X, 2, 6) \
+    OP(0x0F, SLO, slo, ABSOLUTE,    3, 6) \
+    OP(0x1F, SLO, slo, ABSOLUTE_X,  3, 7) \
+    OP(0x1B, SLO, slo, ABSOLUTE_Y,  3, 7) \
+    OP(0x03, SLO, slo, INDIRECT_X,  2, 8) \
+    OP(0x13, SLO, slo, INDIRECT_Y,  2, 8) \
+    \
+    OP(0x27, RLA, rla, ZERO_PAGE,   2, 5) \
+    OP(0x37, RLA, rla, ZERO_PAGE_X, 2, 6) \
+    OP(0x2F, RLA, rla, ABSOLUTE,    3, 6) \
+    OP(0x3F, RLA, rla, ABSOLUTE_X,  3, 7) \
+    OP(0x3B, RLA, rla, ABSOLUTE_Y,  3, 7) \
+    OP(0x23, RLA, rla, INDIRECT_X,  2, 8) \
+    OP(0x33, RLA, rla, INDIRECT_Y,  2, 8) \
+    \
+    OP(0x47, SRE, sre, ZERO_PAGE,   2, 5) \
+    OP(0x57, SRE, sre, ZERO_PAGE_X, 2, 6) \
+    OP(0x4F, SRE, sre, ABSOLUTE,    3, 6) \
+    OP(0x5F, SRE, sre, ABSOLUTE_X,  3, 7) \
+    OP(0x5B, SRE, sre, ABSOLUTE_Y,  3, 7) \
+    OP(0x43, SRE, sre, INDIRECT_X,  2, 8) \
+    OP(0x53, SRE, sre, INDIRECT_Y,  2, 8) \
+    \
+    OP(0x67, RRA, rra, ZERO_PAGE,   2, 5) \
+    OP(0x77, RRA, rra, ZERO_PAGE_X, 2, 6) \
+    OP(0x6F, RRA, rra, ABSOLUTE,    3, 6) \
+    OP(0x7F, RRA, rra, ABSOLUTE_X,  3, 7) \
+    OP(0x7B, RRA, rra, ABSOLUTE_Y,  3, 7) \
+    OP(0x63, RRA, rra, INDIRECT_X,  2, 8) \
+    OP(0x73, RRA, rra, INDIRECT_Y,  2, 8) \
+    \
+    /* === IMEDIATOS === */ \
+    OP(0xEB, SBC, sbc, IMMEDIATE,   2, 2) \
+    OP(0x0B, ANC, anc, IMMEDIATE,   2, 2) \
+    OP(0x2B, ANC, anc, IMMEDIATE,   2, 2) \
+    OP(0x4B, ALR, alr, IMMEDIATE,   2, 2) \
+    OP(0x6B, ARR, arr, IMMEDIATE,   2, 2) \
+    OP(0xCB, AXS, axs, IMMEDIATE,   2, 2) \
+    OP(0x8B, XAA, xaa, IMMEDIATE,   2, 2) \
+    \
+    /* === STORES COM HIGH BYTE (instáveis) === */ \
+    OP(0x93, AHX, ahx, INDIRECT_Y,  2, 6) \
+    OP(0x9F, AHX, ahx, ABSOLUTE_Y,  3, 5) \
+    OP(0x9C, SHY, shy, ABSOLUTE_X,  3, 5) \
+    OP(0x9E, SHX, shx, ABSOLUTE_Y,  3, 5) \
+    OP(0x9B, TAS, tas, ABSOLUTE_Y,  3, 5) \
+    \
+    /* === JAM (trava a CPU) === */ \
+    OP(0x02, JAM, jam, IMPLIED,     1, 2) \
+    OP(0x12, JAM, jam, IMPLIED,     1, 2) \
+    OP(0x22, JAM, jam, IMPLIED,     1, 2) \
+    OP(0x32, JAM, jam, IMPLIED,     1, 2) \
+    OP(0x42, JAM, jam, IMPLIED,     1, 2) \
+    OP(0x52, JAM, jam, IMPLIED,     1, 2) \
+    OP(0x62, JAM, jam, IMPLIED,     1, 2) \
+    OP(0x72, JAM, jam, IMPLIED,     1, 2) \
+    OP(0x92, JAM, jam, IMPLIED,     1, 2) \
+    OP(0xB2, JAM, jam, IMPLIED,     1, 2) \
+    OP(0xD2, JAM, jam, IMPLIED,     1, 2) \
+    OP(0xF2, JAM, jam, IMPLIED,     1, 2)
+
+#endif
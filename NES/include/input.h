@@ -0,0 +1,41 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdint.h>
+
+// Controle padrão do NES nas portas $4016/$4017.
+//
+// O host não é consultado durante a emulação: uma vez por frame o loop
+// principal grava o estado dos botões (input_set) e as leituras do jogo
+// só consomem esse snapshot. Assim nada de eventos do SDL no caminho
+// quente, e a mesma sequência de snapshots reproduz o mesmo jogo.
+
+// Botões, na ordem em que saem pelo shift register (bit 0 primeiro)
+#define INPUT_A      0x01
+#define INPUT_B      0x02
+#define INPUT_SELECT 0x04
+#define INPUT_START  0x08
+#define INPUT_UP     0x10
+#define INPUT_DOWN   0x20
+#define INPUT_LEFT   0x40
+#define INPUT_RIGHT  0x80
+
+#define INPUT_PORTS 2
+
+typedef struct {
+    uint8_t buttons[INPUT_PORTS];  // snapshot do frame
+    uint8_t shift[INPUT_PORTS];    // shift register (4021) de cada controle
+    uint8_t strobe;                // bit 0 do último write em $4016
+} nes_input_t;
+
+nes_input_t* input_init(void);
+void input_free(nes_input_t *input);
+
+// Snapshot dos botões de uma porta (0 ou 1), chamado entre frames
+void input_set(nes_input_t *input, int port, uint8_t buttons);
+
+// Write em $4016 (strobe das duas portas) e reads em $4016/$4017
+void    input_write(nes_input_t *input, uint8_t value);
+uint8_t input_read(nes_input_t *input, int port);
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+
+// Log com níveis, máscara por subsistema e fila sem lock.
+//
+// - Nível de compilação: NES_LOG_LEVEL (padrão LOG_LEVEL_INFO). Chamadas
+//   acima dele somem do binário (o if vira constante falsa).
+// - Em tempo de execução: NES_LOG=error|warn|info|debug|trace e
+//   NES_LOG_SYS=cpu,ppu,mmu,video,apu,input,all (variáveis de ambiente).
+// - As mensagens vão para um ring buffer e uma thread escreve no stdout;
+//   se o ring encher, a mensagem é descartada (e contada), nunca bloqueia.
+
+typedef enum {
+    LOG_LEVEL_NONE = 0,
+    LOG_LEVEL_ERROR,
+    LOG_LEVEL_WARN,
+    LOG_LEVEL_INFO,
+    LOG_LEVEL_DEBUG,
+    LOG_LEVEL_TRACE
+} log_level_t;
+
+// Subsistemas (bits da máscara)
+#define LOG_CPU   0x01
+#define LOG_PPU   0x02
+#define LOG_MMU   0x04
+#define LOG_VIDEO 0x08
+#define LOG_APU   0x10
+#define LOG_INPUT 0x20
+#define LOG_ALL   0xFF
+
+#ifndef NES_LOG_LEVEL
+#define NES_LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+extern int log_level;        // nível em tempo de execução
+extern uint32_t log_mask;    // subsistemas ligados
+
+static inline int log_enabled(int level, uint32_t sys) {
+    return level <= log_level && (log_mask & sys);
+}
+
+// Inicia a thread de escrita (sem ela, log_write escreve direto)
+void log_init(void);
+// Esvazia o ring e para a thread
+void log_shutdown(void);
+
+void log_write(int level, uint32_t sys, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// Evento de trace binário: só guarda o tag (string literal) e 2 valores;
+// a formatação fica para a thread de escrita
+void log_trace_event(uint32_t sys, const char *tag, uint32_t a, uint32_t b);
+
+#define NES_LOG(level, sys, ...) do { \
+        if ((level) <= NES_LOG_LEVEL && log_enabled((level), (sys))) \
+            log_write((level), (sys), __VA_ARGS__); \
+    } while (0)
+
+#define LOG_ERROR(sys, ...) NES_LOG(LOG_LEVEL_ERROR, sys, __VA_ARGS__)
+#define LOG_WARN(sys, ...)  NES_LOG(LOG_LEVEL_WARN, sys, __VA_ARGS__)
+#define LOG_INFO(sys, ...)  NES_LOG(LOG_LEVEL_INFO, sys, __VA_ARGS__)
+#define LOG_DEBUG(sys, ...) NES_LOG(LOG_LEVEL_DEBUG, sys, __VA_ARGS__)
+
+#define LOG_TRACE(sys, tag, a, b) do { \
+        if (LOG_LEVEL_TRACE <= NES_LOG_LEVEL && log_enabled(LOG_LEVEL_TRACE, (sys))) \
+            log_trace_event((sys), (tag), (uint32_t)(a), (uint32_t)(b)); \
+    } while (0)
+
+#endif
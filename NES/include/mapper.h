@@ -0,0 +1,58 @@
+#ifndef MAPPER_H
+#define MAPPER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "rom.h"
+#include "ppu.h"
+
+struct nes_memory_t;
+
+// Mapper do cartucho. A troca de banco não passa por aqui a cada acesso:
+// o mapper reescreve as páginas diretas da CPU (memory.h) e as janelas
+// de CHR da PPU, e o caminho rápido continua sendo um load indexado.
+// Os hooks só são chamados no que cai fora das páginas diretas.
+typedef struct nes_mapper_t {
+    const char *name;
+    int number;
+
+    nes_rom_t *rom;
+    struct nes_memory_t *mem;
+    nes_ppu_t *ppu;
+
+    // Reaplica os bancos atuais (páginas da CPU, CHR, espelhamento)
+    void (*remap)(struct nes_mapper_t *m);
+
+    // $4020-$FFFF sem página direta (registradores do mapper)
+    uint8_t (*cpu_read)(struct nes_mapper_t *m, uint16_t addr);
+    void    (*cpu_write)(struct nes_mapper_t *m, uint16_t addr, uint8_t value);
+
+    // Pattern tables via $2007 (opcional; sem hook usa as janelas de CHR)
+    uint8_t (*ppu_read)(struct nes_mapper_t *m, uint16_t addr);
+    void    (*ppu_write)(struct nes_mapper_t *m, uint16_t addr, uint8_t value);
+
+    // Fim de scanline com renderização ligada (contadores de IRQ)
+    void (*scanline)(struct nes_mapper_t *m);
+    // Linha de IRQ do cartucho (1 = ativa)
+    int  (*irq)(struct nes_mapper_t *m);
+    // Previsão: quantas chamadas de scanline até o IRQ disparar (-1 = nunca)
+    int  (*irq_clocks)(struct nes_mapper_t *m);
+
+    void *ctx;        // estado específico do mapper (sem ponteiros)
+    size_t ctx_size;  // bytes de ctx (entra no save state)
+} nes_mapper_t;
+
+// Cria o mapper da ROM (0 NROM, 1 MMC1, 2 UxROM, 3 CNROM, 4 MMC3)
+nes_mapper_t* mapper_create(nes_rom_t *rom, struct nes_memory_t *mem, nes_ppu_t *ppu);
+void mapper_free(nes_mapper_t *m);
+
+// Helpers de banco: bank negativo conta do fim (-1 = último)
+void mapper_map_prg_8k(nes_mapper_t *m, int slot, int bank);   // slot 0-3 = $8000/$A000/$C000/$E000
+void mapper_map_prg_16k(nes_mapper_t *m, int slot, int bank);  // slot 0-1 = $8000/$C000
+void mapper_map_prg_32k(nes_mapper_t *m, int bank);
+void mapper_map_chr_1k(nes_mapper_t *m, int slot, int bank);   // slot 0-7
+void mapper_map_chr_2k(nes_mapper_t *m, int slot, int bank);   // slot 0-3
+void mapper_map_chr_4k(nes_mapper_t *m, int slot, int bank);   // slot 0-1
+void mapper_map_chr_8k(nes_mapper_t *m, int bank);
+
+#endif
@@ -4,19 +4,62 @@
 #include <stdint.h>
 #include "ppu.h"
 #include "rom.h"
+#include "mapper.h"
+#include "apu.h"
+#include "input.h"
+#include "profile.h"
 
 // Estrutura completa
 typedef struct nes_memory_t {
+    // ram e prg_ram: estado salvo em bloco (state.c)
     uint8_t ram[0x0800];   // 2KB de RAM
+    uint8_t prg_ram[0x2000]; // PRG-RAM do cartucho ($6000-$7FFF)
     uint8_t *prg_rom;      // Ponteiro pra PRG-ROM
     nes_rom_t *rom;        // Referência pra ROM
     nes_ppu_t *ppu;        // PPU
+    nes_apu_t *apu;        // APU ($4000-$4017)
+    nes_input_t *input;    // controles ($4016/$4017)
+    struct nes_cpu_t *cpu; // CPU dona do relógio (catch-up da PPU)
+    nes_mapper_t *mapper;  // bancos de PRG/CHR do cartucho
+
+    // Mapa de páginas de 256 bytes: ponteiro direto para RAM/ROM, ou
+    // NULL para cair nos handlers de I/O ($2000-$401F, não mapeado)
+    uint8_t *read_page[256];
+    uint8_t *write_page[256];
 } nes_memory_t;
 
 // API
 nes_memory_t* memory_init(nes_rom_t *rom);
 void memory_free(nes_memory_t *mem);
-uint8_t memory_read(nes_memory_t *mem, uint16_t addr);
-void memory_write(nes_memory_t *mem, uint16_t addr, uint8_t value);
+
+// Remonta o mapa de páginas inteiro (init / load de estado); trocas de
+// banco do mapper só reescrevem as próprias páginas
+void memory_map_rebuild(nes_memory_t *mem);
+
+// Caminho lento: registradores e áreas sem página direta
+uint8_t memory_read_io(nes_memory_t *mem, uint16_t addr);
+void memory_write_io(nes_memory_t *mem, uint16_t addr, uint8_t value);
+
+// DMA de sprites ($4014): copia a página $XX00-$XXFF para a OAM e
+// retorna quantos ciclos a CPU fica parada (513 ou 514)
+int memory_oam_dma(nes_memory_t *mem, uint8_t page);
+
+// Caminho rápido: RAM e ROM viram um load indexado
+static inline uint8_t memory_read(nes_memory_t *mem, uint16_t addr) {
+    PROFILE_MEM(addr, 0);
+    const uint8_t *page = mem->read_page[addr >> 8];
+    if (page) return page[addr & 0xFF];
+    return memory_read_io(mem, addr);
+}
+
+static inline void memory_write(nes_memory_t *mem, uint16_t addr, uint8_t value) {
+    PROFILE_MEM(addr, 1);
+    uint8_t *page = mem->write_page[addr >> 8];
+    if (page) {
+        page[addr & 0xFF] = value;
+        return;
+    }
+    memory_write_io(mem, addr, value);
+}
 
 #endif
@@ -0,0 +1,69 @@
+#ifndef MOVIE_H
+#define MOVIE_H
+
+#include <stdint.h>
+#include "cpu.h"
+#include "input.h"
+
+// Movie: os botões de cada frame desde o power-on, mais um hash do
+// framebuffer e da RAM no fim de cada frame.
+//
+// A emulação é determinística (input só entra pelo snapshot do frame,
+// input.h), então reproduzir os mesmos botões a partir do power-on tem
+// que dar os mesmos hashes. Serve de carga de trabalho real para medir
+// desempenho e de teste de regressão: qualquer otimização que mude o
+// comportamento aparece como hash diferente.
+//
+// Os frames são indexados por ppu->frame (relativo ao início do movie):
+// se a emulação voltar (rewind), a gravação continua dali e descarta o
+// que vinha depois.
+
+#define MOVIE_MAGIC   0x4D53454Eu  // "NESM"
+#define MOVIE_VERSION 2  // 2: começa do power-on limpo (sem o preenchimento de teste da nametable)
+
+typedef struct {
+    uint64_t hash;                  // framebuffer + RAM no fim do frame
+    uint8_t  buttons[INPUT_PORTS];  // snapshot usado no frame
+    uint8_t  reserved[6];
+} movie_frame_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t frames;
+    uint16_t mapper;
+    uint16_t prg_banks;
+    uint64_t rom_hash;              // hash da PRG-ROM
+} movie_header_t;
+
+typedef struct {
+    char *path;
+    movie_header_t header;          // desta ROM (frames preenchido ao gravar)
+    int recording;                  // 1 = gravando, 0 = reproduzindo
+    int start_frame;                // ppu->frame do frame 0 do movie
+    int current;                    // índice do frame em curso
+
+    movie_frame_t *frames;
+    int count, capacity;
+
+    int mismatches;                 // replay: frames com hash diferente
+    int first_mismatch;             // -1 = nenhum
+} nes_movie_t;
+
+// Gravação: o arquivo é escrito em movie_close
+nes_movie_t* movie_record(nes_cpu_t *cpu, const char *path);
+// Reprodução: NULL se o arquivo não existir, estiver vazio ou for de outra ROM
+nes_movie_t* movie_replay(nes_cpu_t *cpu, const char *path);
+
+// Em volta de cada nes_run_frame (movie NULL = nada). Antes: no replay,
+// aplica os botões do frame. Depois: grava ou confere o hash.
+void movie_before_frame(nes_movie_t *movie, nes_cpu_t *cpu);
+void movie_after_frame(nes_movie_t *movie, nes_cpu_t *cpu);
+
+// Replay chegou ao fim (a partir daí o input volta para o host)
+int movie_finished(nes_movie_t *movie);
+
+// Grava (se gravando) e libera; retorna 0 se a gravação falhou
+int movie_close(nes_movie_t *movie);
+
+#endif
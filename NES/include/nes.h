@@ -0,0 +1,21 @@
+#ifndef NES_H
+#define NES_H
+
+#include "cpu.h"
+#include "ppu.h"
+
+// Roda CPU + PPU + APU até a PPU fechar o frame atual e entrega o frame
+// ao backend de vídeo. A CPU roda em lotes (cpu_run) até o próximo evento
+// previsto (VBlank, fim de frame, IRQ do mapper ou da APU); a PPU alcança
+// a CPU nos acessos a $2000-$3FFF e no fim de cada lote, a APU nos
+// acessos a $4000-$4017 e no fim do frame (amostras em apu->samples).
+// present = 0 emula o frame sem entregá-lo ao vídeo (fast-forward).
+void nes_run_frame(nes_cpu_t *cpu, nes_ppu_t *ppu, int present);
+
+// Clock da CPU NTSC
+#define NES_CPU_HZ 1789773.0
+
+// Frame NTSC: (341 * 262 - 0,5) / 3 = 29780,5 ciclos de CPU, 60,0988 Hz
+#define NES_FRAME_NS 16639261ull
+
+#endif
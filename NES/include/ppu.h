@@ -7,44 +7,116 @@
 // Forward declaration para evitar dependência circular
 struct nes_cpu_t;
 typedef struct nes_cpu_t nes_cpu_t;
+struct nes_video_sink_t;
+struct nes_mapper_t;
 
 #define NES_SCREEN_WIDTH  256
 #define NES_SCREEN_HEIGHT 240
 
+// Temporização NTSC
+#define PPU_DOTS_PER_SCANLINE 341
+#define PPU_SCANLINES         262
+#define PPU_VBLANK_SCANLINE   241
+#define PPU_PRERENDER_LINE    261
+
+// Espelhamento das nametables
+#define PPU_MIRROR_HORIZONTAL  0
+#define PPU_MIRROR_VERTICAL    1
+#define PPU_MIRROR_SINGLE_LOW  2
+#define PPU_MIRROR_SINGLE_HIGH 3
+
 typedef struct {
     nes_rom_t *rom;
+    struct nes_mapper_t *mapper; // hooks de scanline / $2007 (NULL = nenhum)
+    uint8_t *chr_mem;       // CHR-ROM inteira da ROM ou chr_ram (8 KB)
+    uint32_t chr_size;
+    int chr_writable;       // 1 = CHR-RAM
+    uint8_t *chr_bank[8];   // janelas de 1 KB de $0000-$1FFF dentro de chr_mem
+    int chr_bank_tile[8];   // primeiro tile físico de cada janela
+    uint8_t *nametable[4];  // $2000/$2400/$2800/$2C00 → vram conforme espelhamento
 
-    // Arrays fixos (não ponteiros!)
+    // Cache de tiles decodificados, indexado pelo tile físico de chr_mem
+    // (troca de banco não invalida nada): cada linha do tile expandida
+    // em 8 bytes (índice de cor 0-3 por pixel)
+    uint8_t (*chr_decoded)[8][8];
+    uint8_t *chr_dirty;      // 1 = precisa decodificar de novo
+
+    // Arrays fixos (não ponteiros!). De vram até cpu_time é o estado
+    // salvo em bloco (state.c)
     uint8_t vram[0x800];    // Name tables (2 KB)
     uint8_t palette[32];    // Palette RAM (32 bytes)
+    uint32_t palette_argb[32]; // palette já resolvida em ARGB (atualizada nos writes)
     uint8_t oam[256];       // OAM (sprites)
+    uint8_t chr_ram[0x2000];// CHR-RAM para cartuchos sem CHR-ROM
 
     // Registradores PPU
-    uint16_t ppu_addr;
-    uint8_t  ppu_addr_latch;
     uint8_t  ppuctrl;
     uint8_t  ppumask;
     uint8_t  ppustatus;
-    uint8_t  ppuscroll_x;
-    uint8_t  ppuscroll_y;
-    uint8_t  ppuscroll_latch;
+    uint8_t  oamaddr;
+    uint8_t  ppudata_buffer; // leitura de $2007 é atrasada em 1
+
+    // Registradores internos de scroll ("loopy")
+    uint16_t v;   // endereço VRAM atual (yyy NN YYYYY XXXXX)
+    uint16_t t;   // endereço VRAM temporário (topo-esquerda da tela)
+    uint8_t  x;   // fine X (3 bits)
+    uint8_t  w;   // latch do primeiro/segundo write em $2005/$2006
+
+    // Pipeline do background: cada fetch de tile escreve 8 pixels
+    // (endereço de paleta 0-15) na fila da linha; o pixel x da tela
+    // é bg_line[x + fine X]. Slots 0-1 vêm do fim da linha anterior.
+    uint8_t  bg_next_tile;
+    uint8_t  bg_next_attr;
+    uint8_t  bg_line[34 * 8];
+
+    // Sprites da próxima scanline (avaliados no dot 257)
+    uint8_t  secondary_oam[32];
+    int      sprite_count;
+    // Por pixel: bits 0-4 = endereço de paleta, 0x20 = atrás do BG, 0x40 = sprite 0
+    uint8_t  sprite_line[NES_SCREEN_WIDTH];
+
+    int nmi_pending;        // NMI a entregar no próximo ppu_step
 
     // Temporização
     int cycle;
     int scanline;
     int frame;
+    uint64_t cpu_time;      // ciclo de CPU até onde a PPU já foi emulada
+
+    // Framebuffer em memória (ARGB8888), independente do SDL
+    uint32_t framebuffer[NES_SCREEN_HEIGHT][NES_SCREEN_WIDTH];
+    struct nes_video_sink_t *video; // para onde vão os frames prontos (NULL = nenhum)
 } nes_ppu_t;
 
 // Funções
 nes_ppu_t* ppu_init(nes_rom_t *rom);
 void ppu_free(nes_ppu_t *ppu);
+void ppu_set_mirroring(nes_ppu_t *ppu, int mode);
+
+// Marca tiles do cache como sujos (endereços da PPU, bancos atuais)
+void ppu_chr_invalidate(nes_ppu_t *ppu, uint16_t addr, uint16_t len);
+
+// Aponta a janela de 1 KB slot (0-7) para o offset dado dentro de chr_mem
+void ppu_set_chr_bank(nes_ppu_t *ppu, int slot, uint32_t offset);
 
+// Fim de frame: o framebuffer já foi preenchido pelo ppu_step
 void ppu_render(nes_ppu_t *ppu);
 void ppu_render_chr_rom(nes_ppu_t *ppu, uint8_t *chr_rom);
 
+// Entrega o framebuffer ao backend de vídeo (video.h)
+void ppu_present(nes_ppu_t *ppu);
+
 uint8_t ppu_read(nes_ppu_t *ppu, uint16_t addr);
 void    ppu_write(nes_ppu_t *ppu, uint16_t addr, uint8_t value);
 
+// Avança 1 dot (pixel) da PPU (não mexe em cpu_time)
 void ppu_step(nes_ppu_t *ppu, nes_cpu_t *cpu);
 
+// Emula a PPU até o ciclo de CPU cpu_cycle (3 dots por ciclo)
+void ppu_catch_up(nes_ppu_t *ppu, nes_cpu_t *cpu, uint64_t cpu_cycle);
+
+// Ciclo de CPU do próximo evento que a CPU não pode atravessar sem a
+// PPU em dia (início do VBlank/NMI, IRQ previsto do mapper ou fim do frame)
+uint64_t ppu_next_event(nes_ppu_t *ppu);
+
 #endif
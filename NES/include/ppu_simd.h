@@ -0,0 +1,22 @@
+#ifndef PPU_SIMD_H
+#define PPU_SIMD_H
+
+#include <stdint.h>
+
+// Kernels da PPU com versões escalar / SSE2 / AVX2, escolhidas em
+// tempo de execução por ppu_simd_init() conforme a CPU do host.
+
+// Expande um tile (16 bytes: plano baixo + plano alto) em 8x8 índices 0-3
+extern void (*ppu_decode_tile)(const uint8_t *src, uint8_t dst[64]);
+
+// Compõe 8 pixels de BG (endereço de paleta 0-15, 0 = transparente) e
+// sprite (formato de sprite_line) e resolve para ARGB pela paleta de 32
+// entradas. Retorna a máscara (bit i = pixel i) de colisões do sprite 0.
+extern int (*ppu_compose_span8)(const uint8_t *bg, const uint8_t *sp,
+                                const uint32_t *palette, uint32_t *dst);
+
+// Seleciona os kernels; NES_SIMD=scalar|sse2|avx2 força uma versão
+void ppu_simd_init(void);
+const char* ppu_simd_name(void);
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+
+// Profiler da CPU (build com -DNES_PROFILE).
+//
+// Conta, por instrução executada: execuções e ciclos por opcode (e daí
+// por modo de endereçamento), por endereço de PC e por pilha de chamadas
+// do 6502 (JSR e NMI/IRQ empilham numa pilha sombra, que desempilha
+// seguindo o SP real: RTS/RTI e saídas por PLA/TXS), além
+// dos acessos à memória por região. No fim, profile_write gera um
+// relatório ordenado (.txt) e um arquivo de pilhas "folded" (.folded)
+// que o flamegraph.pl / speedscope abrem direto.
+//
+// Sem NES_PROFILE as macros abaixo não geram código nenhum.
+
+// Regiões do mapa de memória da CPU
+enum {
+    PROFILE_REGION_RAM,     // $0000-$1FFF
+    PROFILE_REGION_PPU,     // $2000-$3FFF
+    PROFILE_REGION_IO,      // $4000-$401F (APU, DMA, controles)
+    PROFILE_REGION_EXP,     // $4020-$5FFF
+    PROFILE_REGION_SRAM,    // $6000-$7FFF
+    PROFILE_REGION_PRG,     // $8000-$FFFF (inclui busca de opcodes)
+    PROFILE_REGIONS
+};
+
+#ifdef NES_PROFILE
+
+extern uint64_t profile_mem_access[2][PROFILE_REGIONS];   // [0 = leitura, 1 = escrita]
+
+static inline int profile_region(uint16_t addr) {
+    if (addr < 0x2000) return PROFILE_REGION_RAM;
+    if (addr < 0x4000) return PROFILE_REGION_PPU;
+    if (addr < 0x4020) return PROFILE_REGION_IO;
+    if (addr < 0x6000) return PROFILE_REGION_EXP;
+    if (addr < 0x8000) return PROFILE_REGION_SRAM;
+    return PROFILE_REGION_PRG;
+}
+
+// Instrução no endereço pc gastou cycles ciclos e deixou PC e SP em
+// next_pc e sp
+void profile_instruction(uint16_t pc, uint8_t opcode, uint32_t cycles, uint16_t next_pc, uint8_t sp);
+// Interrupção atendida (nmi = 1 para NMI, 0 para IRQ); handler = novo PC
+void profile_interrupt(int nmi, uint16_t handler, uint8_t sp);
+
+// Grava <prefix>.txt e <prefix>.folded; 0 = erro
+int profile_write(const char *prefix);
+
+#define PROFILE_MEM(addr, write)   (profile_mem_access[(write)][profile_region(addr)]++)
+#define PROFILE_INSTRUCTION(pc, opcode, cycles, next_pc, sp) \
+    profile_instruction((pc), (opcode), (uint32_t)(cycles), (next_pc), (sp))
+#define PROFILE_INTERRUPT(nmi, handler, sp) profile_interrupt((nmi), (handler), (sp))
+
+#else
+
+#define PROFILE_MEM(addr, write)                              ((void)0)
+#define PROFILE_INSTRUCTION(pc, opcode, cycles, next_pc, sp)  ((void)0)
+#define PROFILE_INTERRUPT(nmi, handler, sp)                   ((void)0)
+
+#endif
+
+#endif
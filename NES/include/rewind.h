@@ -0,0 +1,55 @@
+#ifndef REWIND_H
+#define REWIND_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cpu.h"
+
+// Rewind: ring em memória com um save state (state.h) por frame.
+//
+// A cada REWIND_KEY_INTERVAL frames entra um keyframe; os frames entre
+// eles guardam só o XOR com o keyframe anterior, que é quase todo zero,
+// comprimido com RLE de zeros. Tudo fica num único bloco de bytes
+// circular de tamanho fixo: quando enche, os frames mais antigos saem
+// (junto com os deltas que dependiam de um keyframe que saiu).
+
+#define REWIND_KEY_INTERVAL 60   // 1 keyframe por segundo
+
+typedef struct {
+    uint32_t offset;   // início em data
+    uint32_t length;   // bytes comprimidos
+    uint8_t  key;      // 1 = keyframe (XOR com zeros)
+} rewind_entry_t;
+
+typedef struct {
+    size_t state_size;
+    uint8_t *state;           // scratch: estado atual / decodificado
+    uint8_t *key;             // estado bruto do último keyframe (referência dos deltas)
+    uint8_t *encoded;         // scratch: saída do encoder antes de ir para o ring
+    int since_key;            // frames desde o último keyframe
+
+    // Bytes comprimidos (circular)
+    uint8_t *data;
+    uint32_t data_size;
+    uint32_t write_pos;       // fim da entrada mais nova
+
+    // Índice das entradas (circular, da mais antiga à mais nova)
+    rewind_entry_t *entries;
+    int capacity, first, count;
+} nes_rewind_t;
+
+// seconds = frames guardados no máximo (a 60 fps); budget = bytes do ring
+nes_rewind_t* rewind_init(nes_cpu_t *cpu, int seconds, size_t budget);
+void rewind_free(nes_rewind_t *rw);
+
+// Guarda o estado do fim do frame atual (chamar 1 vez por frame)
+void rewind_push(nes_rewind_t *rw, nes_cpu_t *cpu);
+
+// Volta ao estado mais novo do ring e o retira; 0 = ring vazio
+int rewind_pop(nes_rewind_t *rw, nes_cpu_t *cpu);
+
+// Frames disponíveis e bytes comprimidos em uso
+int    rewind_frames(nes_rewind_t *rw);
+size_t rewind_bytes(nes_rewind_t *rw);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef STATE_H
+#define STATE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "cpu.h"
+
+// Save state binário e versionado.
+//
+// Cabeçalho fixo seguido dos blocos de estado de CPU, RAM, PPU, APU,
+// controles e mapper, copiados direto das structs (trechos sem ponteiros,
+// marcados nos headers). Salvar e carregar são só memcpy num buffer do
+// chamador, sem alocar nada: rápido o bastante para um snapshot por frame.
+// O formato vale para o mesmo build e a mesma ROM; qualquer mudança nas
+// structs muda o tamanho e o load recusa. Mudou o layout de propósito,
+// sobe STATE_VERSION.
+
+#define STATE_MAGIC   0x5353454Eu  // "NESS"
+#define STATE_VERSION 2
+
+// Bytes necessários para o estado desta máquina (depende do mapper)
+size_t state_size(nes_cpu_t *cpu);
+
+// Grava em buf; retorna os bytes escritos ou 0 se capacity não bastar
+size_t state_save(nes_cpu_t *cpu, uint8_t *buf, size_t capacity);
+
+// Restaura de buf (entre frames); 1 = ok, 0 = estado inválido ou de
+// outra ROM/versão (nada é alterado)
+int state_load(nes_cpu_t *cpu, const uint8_t *buf, size_t size);
+
+#endif
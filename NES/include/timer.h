@@ -0,0 +1,69 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// Relógio monotônico em nanossegundos (não depende do SDL)
+static inline uint64_t timer_now_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// Dorme pelo menos ns nanossegundos (cede a CPU, sem busy-wait)
+static inline void timer_sleep_ns(uint64_t ns) {
+#ifdef _WIN32
+    Sleep((DWORD)((ns + 999999) / 1000000));
+#else
+    struct timespec ts = { (time_t)(ns / 1000000000ull), (long)(ns % 1000000000ull) };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+// ======================
+// Pacer de frames
+// ======================
+// Prazo absoluto: cada frame tem hora marcada (início + n * período),
+// então um sleep que acorda atrasado não acumula erro no ritmo. Ficando
+// mais de TIMER_PACER_MAX_LAG períodos para trás (janela arrastada,
+// debugger), recomeça do agora em vez de correr para recuperar.
+// No Windows o Sleep tem a resolução do timer do sistema; o SDL já a
+// deixa em 1 ms ao inicializar.
+#define TIMER_PACER_MAX_LAG 4
+
+typedef struct {
+    uint64_t period;    // ns por frame
+    uint64_t deadline;  // quando o próximo frame pode começar
+} timer_pacer_t;
+
+static inline void timer_pacer_start(timer_pacer_t *p, uint64_t period_ns) {
+    p->period = period_ns;
+    p->deadline = timer_now_ns() + period_ns;
+}
+
+// Dorme até o prazo do frame atual e marca o do próximo
+static inline void timer_pacer_wait(timer_pacer_t *p) {
+    uint64_t now = timer_now_ns();
+    if (now < p->deadline) {
+        timer_sleep_ns(p->deadline - now);
+    } else if (now - p->deadline > TIMER_PACER_MAX_LAG * p->period) {
+        p->deadline = now;
+    }
+    p->deadline += p->period;
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef VIDEO_H
+#define VIDEO_H
+
+#include <stdint.h>
+
+// Tamanho de um frame completo (ARGB8888, 256x240)
+#define VIDEO_FRAME_PIXELS (256 * 240)
+#define VIDEO_FRAME_BYTES  (VIDEO_FRAME_PIXELS * sizeof(uint32_t))
+
+// Teclas do emulador (não vão para o jogo)
+#define VIDEO_HOTKEY_REWIND 0x01
+
+// --- Interface de saída de vídeo ---
+// A PPU só entrega frames prontos; quem apresenta (SDL, arquivo, ...)
+// fica atrás desta interface.
+typedef struct nes_video_sink_t {
+    const char *name;
+    int  (*init)(struct nes_video_sink_t *sink);                          // 1 = ok
+    void (*present)(struct nes_video_sink_t *sink, const uint32_t *frame); // frame 256x240
+    int  (*poll_quit)(struct nes_video_sink_t *sink);                     // 1 = usuário pediu para sair (pode ser NULL)
+    uint8_t (*buttons)(struct nes_video_sink_t *sink);                    // controle 1 (INPUT_*), após poll_quit (pode ser NULL)
+    uint8_t (*hotkeys)(struct nes_video_sink_t *sink);                    // VIDEO_HOTKEY_*, após poll_quit (pode ser NULL)
+    void (*shutdown)(struct nes_video_sink_t *sink);
+    void *ctx;                                                            // estado do backend
+} nes_video_sink_t;
+
+// --- Backends ---
+nes_video_sink_t* video_null_create(void);
+nes_video_sink_t* video_file_create(const char *path);            // dump raw de todos os frames
+nes_video_sink_t* video_shm_create(const char *name, int slots);  // ring em memória compartilhada
+#ifndef NES_HEADLESS
+nes_video_sink_t* video_sdl_create(int scale);                    // janela SDL (video_sdl.c)
+#endif
+
+// Apresentação em thread própria com triple buffer: present() só copia
+// o frame e retorna, nunca espera vsync nem driver.
+nes_video_sink_t* video_threaded_create(nes_video_sink_t *inner);
+
+// Cria a partir de uma string: "sdl", "null", "file:<path>", "shm:<nome>"
+nes_video_sink_t* video_create(const char *spec);
+
+// --- API ---
+int  video_init(nes_video_sink_t *sink);
+void video_present(nes_video_sink_t *sink, const uint32_t *frame);
+int  video_should_quit(nes_video_sink_t *sink);
+// Botões do controle 1 vindos da janela (0 se o backend não tiver teclado)
+uint8_t video_buttons(nes_video_sink_t *sink);
+uint8_t video_hotkeys(nes_video_sink_t *sink);
+void video_free(nes_video_sink_t *sink);
+
+#endif
@@ -0,0 +1,583 @@
+#include <stdlib.h>
+#include <string.h>
+#include "apu.h"
+#include "cpu.h"
+#include "memory.h"
+#include "nes.h"
+#include "log.h"
+
+// Escala do mixer: saída máxima (~1.0 no modelo não linear) em amostras de 16 bits
+#define APU_MIX_SCALE 24000
+
+// Frame grande demais sem apu_end_frame (ex.: cpu_step solto): fecha um
+// frame de áudio antes que o blip buffer transborde
+#define APU_FLUSH_CLOCKS 60000
+
+static const uint8_t length_table[32] = {
+    10, 254, 20,  2, 40,  4, 80,  6, 160,  8, 60, 10, 14, 12, 26, 14,
+    12,  16, 24, 18, 48, 20, 96, 22, 192, 24, 72, 26, 16, 28, 32, 30
+};
+
+static const uint8_t duty_table[4][8] = {
+    { 0, 1, 0, 0, 0, 0, 0, 0 },
+    { 0, 1, 1, 0, 0, 0, 0, 0 },
+    { 0, 1, 1, 1, 1, 0, 0, 0 },
+    { 1, 0, 0, 1, 1, 1, 1, 1 }
+};
+
+static const uint8_t triangle_table[32] = {
+    15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1,  0,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15
+};
+
+// Períodos NTSC em ciclos de CPU
+static const uint16_t noise_periods[16] = {
+    4, 8, 16, 32, 64, 96, 128, 160, 202, 254, 380, 508, 762, 1016, 2034, 4068
+};
+
+static const uint16_t dmc_periods[16] = {
+    428, 380, 340, 320, 286, 254, 226, 214, 190, 160, 142, 128, 106, 84, 72, 54
+};
+
+// Passos do frame counter (ciclos de CPU desde o início da sequência)
+static const uint32_t frame_times[2][4] = {
+    { 7457, 14913, 22371, 29829 },
+    { 7457, 14913, 22371, 37281 }
+};
+static const uint32_t frame_period[2] = { 29830, 37282 };
+
+// Mixer não linear (tabelas da NESdev), já em escala de amostra
+static int pulse_mix[31];
+static int tnd_mix[203];
+
+static void mix_tables_init(void) {
+    pulse_mix[0] = 0;
+    for (int n = 1; n < 31; n++) pulse_mix[n] = (int)(95.52 / (8128.0 / n + 100) * APU_MIX_SCALE);
+    tnd_mix[0] = 0;
+    for (int n = 1; n < 203; n++) tnd_mix[n] = (int)(163.67 / (24329.0 / n + 100) * APU_MIX_SCALE);
+}
+
+// ======================
+// Saída e IRQ
+// ======================
+
+// Recalcula a amplitude mixada; a diferença vira um degrau no blip buffer
+static inline void mix_update(nes_apu_t *apu, uint64_t time) {
+    int amp = pulse_mix[apu->out[0] + apu->out[1]] +
+              tnd_mix[3 * apu->out[2] + 2 * apu->out[3] + apu->out[4]];
+    if (amp != apu->amp) {
+        blip_add_delta(apu->blip, (uint32_t)(time - apu->frame_start), amp - apu->amp);
+        apu->amp = amp;
+    }
+}
+
+static inline void set_output(nes_apu_t *apu, int channel, uint8_t value, uint64_t time) {
+    if (apu->out[channel] != value) {
+        apu->out[channel] = value;
+        mix_update(apu, time);
+    }
+}
+
+static void update_irq(nes_apu_t *apu) {
+    nes_cpu_t *cpu = apu->mem->cpu;
+    if (cpu) cpu_set_irq(cpu, CPU_IRQ_APU, apu->frame_irq || apu->dmc_irq);
+}
+
+// ======================
+// Unidades compartilhadas
+// ======================
+static inline uint8_t envelope_volume(const apu_envelope_t *env) {
+    return env->constant ? env->volume : env->decay;
+}
+
+static void envelope_clock(apu_envelope_t *env) {
+    if (env->start) {
+        env->start = 0;
+        env->decay = 15;
+        env->divider = env->volume;
+    } else if (env->divider == 0) {
+        env->divider = env->volume;
+        if (env->decay) env->decay--;
+        else if (env->loop) env->decay = 15;
+    } else {
+        env->divider--;
+    }
+}
+
+static int sweep_target(const apu_pulse_t *p) {
+    int change = p->period >> p->sweep_shift;
+    if (p->sweep_negate) return p->period - change - p->ones_complement;
+    return p->period + change;
+}
+
+static inline int pulse_muted(const apu_pulse_t *p) {
+    return p->period < 8 || sweep_target(p) > 0x7FF;
+}
+
+static void sweep_clock(apu_pulse_t *p) {
+    int target = sweep_target(p);
+    if (p->sweep_divider == 0 && p->sweep_enabled && p->sweep_shift && !pulse_muted(p) && target >= 0) {
+        p->period = (uint16_t)target;
+    }
+    if (p->sweep_divider == 0 || p->sweep_reload) {
+        p->sweep_divider = p->sweep_period;
+        p->sweep_reload = 0;
+    } else {
+        p->sweep_divider--;
+    }
+}
+
+// ======================
+// Saída atual de cada canal
+// ======================
+static inline int pulse_audible(const apu_pulse_t *p) {
+    return p->length && !pulse_muted(p);
+}
+
+static uint8_t pulse_output(const apu_pulse_t *p) {
+    if (!pulse_audible(p) || !duty_table[p->duty][p->step]) return 0;
+    return envelope_volume(&p->env);
+}
+
+static uint8_t noise_output(const apu_noise_t *n) {
+    if (!n->length || (n->lfsr & 1)) return 0;
+    return envelope_volume(&n->env);
+}
+
+// Registradores/envelopes mudaram: recalcula todas as saídas em cpu_time
+static void refresh_outputs(nes_apu_t *apu) {
+    apu->out[0] = pulse_output(&apu->pulse[0]);
+    apu->out[1] = pulse_output(&apu->pulse[1]);
+    apu->out[2] = triangle_table[apu->triangle.step];
+    apu->out[3] = noise_output(&apu->noise);
+    apu->out[4] = apu->dmc.level;
+    mix_update(apu, apu->cpu_time);
+}
+
+// ======================
+// Timers dos canais (de clock em clock, até end)
+// ======================
+
+// Quantos clocks de timer com período period cabem antes de end
+static inline uint64_t clocks_before(uint64_t next, uint64_t end, uint32_t period) {
+    return (end - next + period - 1) / period;
+}
+
+static void pulse_run(nes_apu_t *apu, int i, uint64_t end) {
+    apu_pulse_t *p = &apu->pulse[i];
+    uint32_t period = (p->period + 1u) * 2;
+    if (p->next >= end) return;
+
+    // Canal mudo: a saída fica em 0, o sequenciador anda de uma vez
+    if (!pulse_audible(p)) {
+        uint64_t n = clocks_before(p->next, end, period);
+        p->step = (uint8_t)((p->step + n) & 7);
+        p->next += n * period;
+        return;
+    }
+
+    const uint8_t *duty = duty_table[p->duty];
+    uint8_t volume = envelope_volume(&p->env);
+    while (p->next < end) {
+        p->step = (p->step + 1) & 7;
+        set_output(apu, i, duty[p->step] ? volume : 0, p->next);
+        p->next += period;
+    }
+}
+
+static void triangle_run(nes_apu_t *apu, uint64_t end) {
+    apu_triangle_t *t = &apu->triangle;
+    uint32_t period = t->period + 1u;
+    if (t->next >= end) return;
+
+    // Sequenciador parado (ou ultrassônico, período < 2): saída congelada
+    if (!t->length || !t->linear || t->period < 2) {
+        t->next += clocks_before(t->next, end, period) * period;
+        return;
+    }
+
+    while (t->next < end) {
+        t->step = (t->step + 1) & 31;
+        set_output(apu, 2, triangle_table[t->step], t->next);
+        t->next += period;
+    }
+}
+
+static void noise_run(nes_apu_t *apu, uint64_t end) {
+    apu_noise_t *n = &apu->noise;
+    uint32_t period = n->period;
+    if (n->next >= end) return;
+
+    // Sem length a saída é 0; o LFSR fica parado (não é audível)
+    if (!n->length) {
+        n->next += clocks_before(n->next, end, period) * period;
+        return;
+    }
+
+    int tap = n->mode ? 6 : 1;
+    uint8_t volume = envelope_volume(&n->env);
+    while (n->next < end) {
+        uint16_t feedback = (n->lfsr ^ (n->lfsr >> tap)) & 1;
+        n->lfsr = (uint16_t)((n->lfsr >> 1) | (feedback << 14));
+        set_output(apu, 3, (n->lfsr & 1) ? 0 : volume, n->next);
+        n->next += period;
+    }
+}
+
+static void dmc_restart(apu_dmc_t *d) {
+    d->addr = d->sample_addr;
+    d->remaining = d->sample_length;
+}
+
+// Busca o próximo byte da amostra (o stall de DMA da CPU não é emulado)
+static void dmc_fetch(nes_apu_t *apu) {
+    apu_dmc_t *d = &apu->dmc;
+    d->buffer = memory_read(apu->mem, d->addr);
+    d->buffer_full = 1;
+    d->addr = d->addr == 0xFFFF ? 0x8000 : d->addr + 1;
+
+    if (--d->remaining == 0) {
+        if (d->loop) {
+            dmc_restart(d);
+        } else if (d->irq_enable) {
+            apu->dmc_irq = 1;
+            update_irq(apu);
+        }
+    }
+}
+
+static void dmc_run(nes_apu_t *apu, uint64_t end) {
+    apu_dmc_t *d = &apu->dmc;
+    uint32_t period = d->period;
+    if (d->next >= end) return;
+
+    // Sem amostra: só o contador de bits anda
+    if (d->silence && !d->buffer_full && !d->remaining) {
+        uint64_t n = clocks_before(d->next, end, period);
+        d->bits = (uint8_t)(((d->bits - 1 - n % 8) + 8) % 8 + 1);
+        d->next += n * period;
+        return;
+    }
+
+    while (d->next < end) {
+        if (!d->silence) {
+            if (d->shift & 1) {
+                if (d->level <= 125) d->level += 2;
+            } else if (d->level >= 2) {
+                d->level -= 2;
+            }
+            set_output(apu, 4, d->level, d->next);
+        }
+        d->shift >>= 1;
+
+        if (--d->bits == 0) {
+            d->bits = 8;
+            d->silence = !d->buffer_full;
+            d->shift = d->buffer;
+            d->buffer_full = 0;
+        }
+        if (!d->buffer_full && d->remaining) dmc_fetch(apu);
+        d->next += period;
+    }
+}
+
+// ======================
+// Frame counter
+// ======================
+static void clock_quarter(nes_apu_t *apu) {
+    envelope_clock(&apu->pulse[0].env);
+    envelope_clock(&apu->pulse[1].env);
+    envelope_clock(&apu->noise.env);
+
+    apu_triangle_t *t = &apu->triangle;
+    if (t->linear_reload) t->linear = t->linear_load;
+    else if (t->linear) t->linear--;
+    if (!t->control) t->linear_reload = 0;
+}
+
+static void clock_half(nes_apu_t *apu) {
+    for (int i = 0; i < 2; i++) {
+        apu_pulse_t *p = &apu->pulse[i];
+        if (p->length && !p->env.loop) p->length--;
+        sweep_clock(p);
+    }
+    if (apu->triangle.length && !apu->triangle.control) apu->triangle.length--;
+    if (apu->noise.length && !apu->noise.env.loop) apu->noise.length--;
+}
+
+static void frame_counter_step(nes_apu_t *apu) {
+    int step = apu->frame_step;
+
+    clock_quarter(apu);
+    if (step == 1 || step == 3) clock_half(apu);
+    if (step == 3 && apu->frame_mode == 0 && !apu->irq_inhibit) {
+        apu->frame_irq = 1;
+        update_irq(apu);
+    }
+
+    if (++apu->frame_step == 4) {
+        apu->frame_step = 0;
+        apu->frame_base += frame_period[apu->frame_mode];
+    }
+    apu->frame_next = apu->frame_base + frame_times[apu->frame_mode][apu->frame_step];
+    refresh_outputs(apu);
+}
+
+// ======================
+// Catch-up
+// ======================
+static void apu_flush(nes_apu_t *apu) {
+    blip_end_frame(apu->blip, (uint32_t)(apu->cpu_time - apu->frame_start));
+    apu->frame_start = apu->cpu_time;
+    apu->sample_count = blip_read_samples(apu->blip, apu->samples, APU_MAX_SAMPLES);
+}
+
+// Avança em segmentos: entre dois passos do frame counter os envelopes,
+// length counters e sweeps não mudam, então cada canal roda sozinho
+void apu_catch_up(nes_apu_t *apu, uint64_t cpu_cycle) {
+    while (apu->cpu_time < cpu_cycle) {
+        uint64_t end = cpu_cycle;
+        if (apu->frame_next < end) end = apu->frame_next;
+        if (apu->frame_start + APU_FLUSH_CLOCKS < end) end = apu->frame_start + APU_FLUSH_CLOCKS;
+
+        pulse_run(apu, 0, end);
+        pulse_run(apu, 1, end);
+        triangle_run(apu, end);
+        noise_run(apu, end);
+        dmc_run(apu, end);
+        apu->cpu_time = end;
+
+        if (end == apu->frame_next) frame_counter_step(apu);
+        if (end - apu->frame_start >= APU_FLUSH_CLOCKS) apu_flush(apu);
+    }
+}
+
+uint64_t apu_next_event(nes_apu_t *apu) {
+    uint64_t event = UINT64_MAX;
+
+    if (apu->frame_mode == 0 && !apu->irq_inhibit && !apu->frame_irq) {
+        event = apu->frame_base + frame_times[0][3];
+    }
+
+    // Limite inferior para o fim da amostra: um byte pode estar no
+    // buffer e outro no shift register
+    apu_dmc_t *d = &apu->dmc;
+    if (d->irq_enable && !d->loop && d->remaining && !apu->dmc_irq) {
+        uint64_t bytes = d->remaining > 2 ? d->remaining - 2u : 0;
+        uint64_t dmc_event = d->next + bytes * 8 * d->period;
+        if (dmc_event < event) event = dmc_event;
+    }
+    return event;
+}
+
+void apu_end_frame(nes_apu_t *apu, uint64_t cpu_cycle) {
+    apu_catch_up(apu, cpu_cycle);
+    apu_flush(apu);
+}
+
+// ======================
+// Registradores
+// ======================
+uint8_t apu_read(nes_apu_t *apu, uint16_t addr) {
+    if (addr != 0x4015) return 0;
+
+    uint8_t status = 0;
+    if (apu->pulse[0].length) status |= 0x01;
+    if (apu->pulse[1].length) status |= 0x02;
+    if (apu->triangle.length) status |= 0x04;
+    if (apu->noise.length)    status |= 0x08;
+    if (apu->dmc.remaining)   status |= 0x10;
+    if (apu->frame_irq)       status |= 0x40;
+    if (apu->dmc_irq)         status |= 0x80;
+
+    // Ler $4015 reconhece o IRQ do frame counter
+    apu->frame_irq = 0;
+    update_irq(apu);
+    return status;
+}
+
+static void write_envelope(apu_envelope_t *env, uint8_t value) {
+    env->loop = (value >> 5) & 1;
+    env->constant = (value >> 4) & 1;
+    env->volume = value & 0x0F;
+}
+
+static void write_pulse(nes_apu_t *apu, int i, int reg, uint8_t value) {
+    apu_pulse_t *p = &apu->pulse[i];
+    switch (reg) {
+    case 0:
+        p->duty = value >> 6;
+        write_envelope(&p->env, value);
+        break;
+    case 1:
+        p->sweep_enabled = value >> 7;
+        p->sweep_period = (value >> 4) & 7;
+        p->sweep_negate = (value >> 3) & 1;
+        p->sweep_shift = value & 7;
+        p->sweep_reload = 1;
+        break;
+    case 2:
+        p->period = (p->period & 0x700) | value;
+        break;
+    case 3:
+        p->period = (uint16_t)((p->period & 0xFF) | ((value & 7) << 8));
+        if (apu->enabled & (1 << i)) p->length = length_table[value >> 3];
+        p->step = 0;
+        p->env.start = 1;
+        break;
+    }
+}
+
+void apu_write(nes_apu_t *apu, uint16_t addr, uint8_t value) {
+    apu_triangle_t *t = &apu->triangle;
+    apu_noise_t *n = &apu->noise;
+    apu_dmc_t *d = &apu->dmc;
+
+    switch (addr) {
+    case 0x4000: case 0x4001: case 0x4002: case 0x4003:
+        write_pulse(apu, 0, addr & 3, value);
+        break;
+    case 0x4004: case 0x4005: case 0x4006: case 0x4007:
+        write_pulse(apu, 1, addr & 3, value);
+        break;
+
+    case 0x4008:
+        t->control = value >> 7;
+        t->linear_load = value & 0x7F;
+        break;
+    case 0x400A:
+        t->period = (t->period & 0x700) | value;
+        break;
+    case 0x400B:
+        t->period = (uint16_t)((t->period & 0xFF) | ((value & 7) << 8));
+        if (apu->enabled & 0x04) t->length = length_table[value >> 3];
+        t->linear_reload = 1;
+        break;
+
+    case 0x400C:
+        write_envelope(&n->env, value);
+        break;
+    case 0x400E:
+        n->mode = value >> 7;
+        n->period = noise_periods[value & 0x0F];
+        break;
+    case 0x400F:
+        if (apu->enabled & 0x08) n->length = length_table[value >> 3];
+        n->env.start = 1;
+        break;
+
+    case 0x4010:
+        d->irq_enable = value >> 7;
+        d->loop = (value >> 6) & 1;
+        d->period = dmc_periods[value & 0x0F];
+        if (!d->irq_enable) {
+            apu->dmc_irq = 0;
+            update_irq(apu);
+        }
+        break;
+    case 0x4011:
+        d->level = value & 0x7F;
+        break;
+    case 0x4012:
+        d->sample_addr = (uint16_t)(0xC000 | (value << 6));
+        break;
+    case 0x4013:
+        d->sample_length = (uint16_t)((value << 4) + 1);
+        break;
+
+    case 0x4015:
+        apu->enabled = value & 0x0F;
+        if (!(value & 0x01)) apu->pulse[0].length = 0;
+        if (!(value & 0x02)) apu->pulse[1].length = 0;
+        if (!(value & 0x04)) t->length = 0;
+        if (!(value & 0x08)) n->length = 0;
+        if (!(value & 0x10)) {
+            d->remaining = 0;
+        } else if (!d->remaining) {
+            dmc_restart(d);
+            if (!d->buffer_full) dmc_fetch(apu);
+        }
+        apu->dmc_irq = 0;
+        update_irq(apu);
+        break;
+
+    case 0x4017:
+        apu->frame_mode = value >> 7;
+        apu->irq_inhibit = (value >> 6) & 1;
+        if (apu->irq_inhibit) {
+            apu->frame_irq = 0;
+            update_irq(apu);
+        }
+        // Sequência reinicia; no modo de 5 passos já dá um clock de quarter/half
+        apu->frame_step = 0;
+        apu->frame_base = apu->cpu_time;
+        apu->frame_next = apu->frame_base + frame_times[apu->frame_mode][0];
+        if (apu->frame_mode) {
+            clock_quarter(apu);
+            clock_half(apu);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    refresh_outputs(apu);
+}
+
+// ======================
+// Inicialização e destruição
+// ======================
+nes_apu_t* apu_init(struct nes_memory_t *mem, int sample_rate) {
+    nes_apu_t *apu = calloc(1, sizeof(nes_apu_t));
+    if (!apu) return NULL;
+
+    apu->mem = mem;
+    mix_tables_init();
+    if (!apu_set_sample_rate(apu, sample_rate)) {
+        free(apu);
+        return NULL;
+    }
+
+    apu->pulse[0].ones_complement = 1;
+    apu->noise.lfsr = 1;
+    apu->noise.period = noise_periods[0];
+    apu->dmc.period = dmc_periods[0];
+    apu->dmc.bits = 8;
+    apu->dmc.silence = 1;
+    apu->frame_next = frame_times[0][0];
+
+    return apu;
+}
+
+void apu_free(nes_apu_t *apu) {
+    if (!apu) return;
+    blip_free(apu->blip);
+    free(apu);
+}
+
+int apu_set_sample_rate(nes_apu_t *apu, int sample_rate) {
+    // apu->samples comporta um frame de até APU_FLUSH_CLOCKS a 48 kHz
+    if (sample_rate < 8000 || sample_rate > 48000) {
+        LOG_ERROR(LOG_APU, "Taxa de áudio não suportada: %d Hz", sample_rate);
+        return 0;
+    }
+
+    nes_blip_t *blip = blip_new(NES_CPU_HZ, sample_rate, APU_MAX_SAMPLES);
+    if (!blip) {
+        LOG_ERROR(LOG_APU, "Erro ao criar blip buffer (%d Hz)", sample_rate);
+        return 0;
+    }
+
+    // Amostras pendentes na taxa antiga são descartadas
+    blip_free(apu->blip);
+    apu->blip = blip;
+    apu->sample_rate = sample_rate;
+    apu->sample_count = 0;
+    LOG_INFO(LOG_APU, "Saída de áudio a %d Hz", sample_rate);
+    return 1;
+}
+
+void apu_set_rate_ratio(nes_apu_t *apu, double ratio) {
+    blip_set_rates(apu->blip, NES_CPU_HZ, apu->sample_rate * ratio);
+}
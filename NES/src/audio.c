@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "audio.h"
+#include "timer.h"
+#include "nes.h"
+#include "log.h"
+
+// Desvio máximo da taxa no dynamic rate control (0,5%: inaudível)
+#define AUDIO_MAX_DELTA 0.005
+// Espera máxima por frame em audio_wait: dispositivo parado (pausado,
+// desconectado) não pode travar a emulação
+#define AUDIO_MAX_WAIT_NS (2 * NES_FRAME_NS)
+
+// ======================
+// Ring SPSC
+// ======================
+int audio_ring_init(nes_audio_ring_t *ring, uint32_t capacity) {
+    uint32_t size = 1;
+    while (size < capacity) size <<= 1;
+
+    ring->data = calloc(size, sizeof(int16_t));
+    if (!ring->data) return 0;
+    ring->mask = size - 1;
+    atomic_store(&ring->head, 0);
+    atomic_store(&ring->tail, 0);
+    return 1;
+}
+
+void audio_ring_free(nes_audio_ring_t *ring) {
+    free(ring->data);
+    ring->data = NULL;
+}
+
+int audio_ring_write(nes_audio_ring_t *ring, const int16_t *samples, int count) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    uint32_t space = ring->mask + 1 - (head - tail);
+    uint32_t n = (uint32_t)count < space ? (uint32_t)count : space;
+
+    // Até duas cópias: do head ao fim do array e do começo em diante
+    uint32_t start = head & ring->mask;
+    uint32_t first = n < ring->mask + 1 - start ? n : ring->mask + 1 - start;
+    memcpy(ring->data + start, samples, first * sizeof(int16_t));
+    memcpy(ring->data, samples + first, (n - first) * sizeof(int16_t));
+
+    atomic_store_explicit(&ring->head, head + n, memory_order_release);
+    return (int)n;
+}
+
+int audio_ring_read(nes_audio_ring_t *ring, int16_t *out, int count) {
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t avail = head - tail;
+    uint32_t n = (uint32_t)count < avail ? (uint32_t)count : avail;
+
+    uint32_t start = tail & ring->mask;
+    uint32_t first = n < ring->mask + 1 - start ? n : ring->mask + 1 - start;
+    memcpy(out, ring->data + start, first * sizeof(int16_t));
+    memcpy(out + first, ring->data, (n - first) * sizeof(int16_t));
+
+    atomic_store_explicit(&ring->tail, tail + n, memory_order_release);
+    return (int)n;
+}
+
+int audio_ring_count(nes_audio_ring_t *ring) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return (int)(head - tail);
+}
+
+// ======================
+// API genérica
+// ======================
+int audio_init(nes_audio_sink_t *sink) {
+    if (!sink) return 0;
+    if (!sink->init) return 1;
+    return sink->init(sink);
+}
+
+void audio_write(nes_audio_sink_t *sink, const int16_t *samples, int count) {
+    if (sink && sink->write && count > 0) sink->write(sink, samples, count);
+}
+
+// Pacing pelo relógio do áudio: dorme o tempo que o excesso acima do
+// alvo leva para tocar (nunca gira em loop esperando). No máximo
+// AUDIO_MAX_WAIT_NS; se o buffer não drenar, o excesso fica para o
+// ajuste de taxa e para os próximos frames
+void audio_wait(nes_audio_sink_t *sink) {
+    if (!sink || !sink->queued || sink->sample_rate <= 0) return;
+
+    int target = sink->buffer_samples / 2;
+    uint64_t waited = 0;
+    while (waited < AUDIO_MAX_WAIT_NS) {
+        int excess = sink->queued(sink) - target;
+        if (excess <= 0) return;
+        uint64_t ns = (uint64_t)excess * 1000000000ull / (uint64_t)sink->sample_rate;
+        if (ns > AUDIO_MAX_WAIT_NS - waited) ns = AUDIO_MAX_WAIT_NS - waited;
+        timer_sleep_ns(ns);
+        waited += ns;
+    }
+}
+
+// Dynamic rate control: buffer abaixo da metade → gera um pouco mais
+// de amostras por frame; acima → um pouco menos
+double audio_rate_ratio(nes_audio_sink_t *sink) {
+    if (!sink || !sink->queued || sink->buffer_samples <= 0) return 1.0;
+
+    double fill = (double)sink->queued(sink) / sink->buffer_samples;
+    if (fill > 1.0) fill = 1.0;
+    return 1.0 + AUDIO_MAX_DELTA * (1.0 - 2.0 * fill);
+}
+
+void audio_free(nes_audio_sink_t *sink) {
+    if (!sink) return;
+    if (sink->shutdown) sink->shutdown(sink);
+    free(sink);
+}
+
+static nes_audio_sink_t* sink_alloc(const char *name, int sample_rate) {
+    nes_audio_sink_t *sink = calloc(1, sizeof(nes_audio_sink_t));
+    if (sink) {
+        sink->name = name;
+        sink->sample_rate = sample_rate;
+    }
+    return sink;
+}
+
+// ======================
+// Null: descarta as amostras
+// ======================
+nes_audio_sink_t* audio_null_create(int sample_rate) {
+    return sink_alloc("null", sample_rate);
+}
+
+// ======================
+// File: WAV mono 16 bits (cabeçalho reescrito no fim)
+// ======================
+typedef struct {
+    char *path;
+    FILE *file;
+    uint32_t samples;
+} audio_file_t;
+
+static void wav_header(FILE *f, int rate, uint32_t samples) {
+    uint32_t data = samples * 2;
+    uint8_t h[44];
+    uint32_t fields[] = { 36 + data, 16, (uint32_t)rate, (uint32_t)rate * 2, data };
+
+    memcpy(h, "RIFF", 4);
+    memcpy(h + 4, &fields[0], 4);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    memcpy(h + 16, &fields[1], 4);
+    h[20] = 1; h[21] = 0;           // PCM
+    h[22] = 1; h[23] = 0;           // mono
+    memcpy(h + 24, &fields[2], 4);
+    memcpy(h + 28, &fields[3], 4);
+    h[32] = 2; h[33] = 0;           // bytes por amostra
+    h[34] = 16; h[35] = 0;          // bits
+    memcpy(h + 36, "data", 4);
+    memcpy(h + 40, &fields[4], 4);
+
+    fseek(f, 0, SEEK_SET);
+    fwrite(h, 1, sizeof(h), f);
+}
+
+static int file_init(nes_audio_sink_t *sink) {
+    audio_file_t *af = sink->ctx;
+    af->file = fopen(af->path, "wb");
+    if (!af->file) {
+        LOG_ERROR(LOG_APU, "Erro ao abrir %s", af->path);
+        return 0;
+    }
+    wav_header(af->file, sink->sample_rate, 0);
+    return 1;
+}
+
+static void file_write(nes_audio_sink_t *sink, const int16_t *samples, int count) {
+    audio_file_t *af = sink->ctx;
+    if (!af->file) return;
+    af->samples += (uint32_t)fwrite(samples, sizeof(int16_t), (size_t)count, af->file);
+}
+
+static void file_shutdown(nes_audio_sink_t *sink) {
+    audio_file_t *af = sink->ctx;
+    if (af->file) {
+        wav_header(af->file, sink->sample_rate, af->samples);
+        fclose(af->file);
+    }
+    free(af->path);
+    free(af);
+}
+
+nes_audio_sink_t* audio_file_create(const char *path, int sample_rate) {
+    nes_audio_sink_t *sink = sink_alloc("file", sample_rate);
+    audio_file_t *af = calloc(1, sizeof(audio_file_t));
+    if (!sink || !af) {
+        free(sink);
+        free(af);
+        return NULL;
+    }
+    af->path = strdup(path);
+    sink->ctx = af;
+    sink->init = file_init;
+    sink->write = file_write;
+    sink->shutdown = file_shutdown;
+    return sink;
+}
+
+// ======================
+// Seleção por string (linha de comando)
+// ======================
+nes_audio_sink_t* audio_create(const char *spec, int sample_rate) {
+    if (strcmp(spec, "null") == 0) return audio_null_create(sample_rate);
+    if (strncmp(spec, "file:", 5) == 0) return audio_file_create(spec + 5, sample_rate);
+#ifndef NES_HEADLESS
+    if (strcmp(spec, "sdl") == 0) return audio_sdl_create(sample_rate);
+#endif
+    LOG_ERROR(LOG_APU, "Backend de áudio desconhecido: %s", spec);
+    return NULL;
+}
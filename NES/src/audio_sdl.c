@@ -0,0 +1,97 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "audio.h"
+#include "log.h"
+
+#define AUDIO_SDL_RING      8192  // amostras (~170 ms a 48 kHz)
+#define AUDIO_SDL_LATENCY   4096  // buffer_samples: alvo de ~43 ms
+#define AUDIO_SDL_CALLBACK  512   // amostras por callback
+
+// Estado do backend SDL
+typedef struct {
+    SDL_AudioDeviceID device;
+    nes_audio_ring_t ring;
+    int16_t last;          // repetido no underrun (evita estalo)
+} audio_sdl_t;
+
+// Roda na thread de áudio do SDL: só lê do ring
+static void sdl_callback(void *userdata, Uint8 *stream, int len) {
+    audio_sdl_t *as = userdata;
+    int16_t *out = (int16_t *)stream;
+    int count = len / (int)sizeof(int16_t);
+
+    int n = audio_ring_read(&as->ring, out, count);
+    if (n > 0) as->last = out[n - 1];
+    for (int i = n; i < count; i++) out[i] = as->last;
+}
+
+static int sdl_init(nes_audio_sink_t *sink) {
+    audio_sdl_t *as = sink->ctx;
+
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+        LOG_ERROR(LOG_APU, "Erro ao inicializar áudio SDL: %s", SDL_GetError());
+        return 0;
+    }
+
+    SDL_AudioSpec want, have;
+    SDL_memset(&want, 0, sizeof(want));
+    want.freq = sink->sample_rate;
+    want.format = AUDIO_S16SYS;
+    want.channels = 1;
+    want.samples = AUDIO_SDL_CALLBACK;
+    want.callback = sdl_callback;
+    want.userdata = as;
+
+    // Sem permitir mudanças: o SDL converte se o dispositivo for diferente
+    as->device = SDL_OpenAudioDevice(NULL, 0, &want, &have, 0);
+    if (!as->device) {
+        LOG_ERROR(LOG_APU, "Erro ao abrir dispositivo de áudio: %s", SDL_GetError());
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return 0;
+    }
+
+    sink->sample_rate = have.freq;
+    SDL_PauseAudioDevice(as->device, 0);
+    return 1;
+}
+
+static void sdl_write(nes_audio_sink_t *sink, const int16_t *samples, int count) {
+    audio_sdl_t *as = sink->ctx;
+    // Ring cheio: o excesso é descartado (o pacing evita chegar aqui)
+    audio_ring_write(&as->ring, samples, count);
+}
+
+static int sdl_queued(nes_audio_sink_t *sink) {
+    audio_sdl_t *as = sink->ctx;
+    return audio_ring_count(&as->ring);
+}
+
+static void sdl_shutdown(nes_audio_sink_t *sink) {
+    audio_sdl_t *as = sink->ctx;
+    if (as->device) {
+        SDL_CloseAudioDevice(as->device);
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    }
+    audio_ring_free(&as->ring);
+    free(as);
+}
+
+nes_audio_sink_t* audio_sdl_create(int sample_rate) {
+    nes_audio_sink_t *sink = calloc(1, sizeof(nes_audio_sink_t));
+    audio_sdl_t *as = calloc(1, sizeof(audio_sdl_t));
+    if (!sink || !as || !audio_ring_init(&as->ring, AUDIO_SDL_RING)) {
+        free(sink);
+        free(as);
+        return NULL;
+    }
+    sink->name = "sdl";
+    sink->sample_rate = sample_rate;
+    sink->buffer_samples = AUDIO_SDL_LATENCY;
+    sink->ctx = as;
+    sink->init = sdl_init;
+    sink->write = sdl_write;
+    sink->queued = sdl_queued;
+    sink->shutdown = sdl_shutdown;
+    return sink;
+}
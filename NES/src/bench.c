@@ -0,0 +1,309 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rom.h"
+#include "cpu.h"
+#include "memory.h"
+#include "ppu.h"
+#include "video.h"
+#include "state.h"
+#include "timer.h"
+#include "nes.h"
+#include "log.h"
+
+// nes_bench: desempenho sem vídeo, para acompanhar regressões.
+//
+// Para cada ROM: aquece alguns frames, guarda o estado (state.h) e faz
+// várias rodadas de N frames, todas partindo desse mesmo estado (mesmo
+// trabalho em cada rodada). Depois mede cpu_step, ppu_step e o custo de
+// renderizar uma scanline visível, isolados, e volta ao estado salvo. Resultado em tabela no
+// stdout e em JSON (--json).
+
+#define BENCH_DEFAULT_FRAMES 600
+#define BENCH_DEFAULT_RUNS   5
+#define BENCH_DEFAULT_WARMUP 120
+#define BENCH_SAMPLES        1000   // amostras de cada micro-benchmark
+#define BENCH_CPU_BATCH      1000   // instruções por amostra
+#define BENCH_PPU_BATCH      (PPU_DOTS_PER_SCANLINE * 10)
+#define BENCH_LINE_SAMPLES   200    // frames (240 linhas cada) da medida de scanline
+#define BENCH_MAX_ROMS       16
+
+#ifdef NES_CPU_GOTO
+#define BENCH_CPU_CORE "goto"
+#else
+#define BENCH_CPU_CORE "table"
+#endif
+
+typedef struct {
+    double median;
+    double p99;
+} bench_stat_t;
+
+typedef struct {
+    const char *path;
+    int mapper;
+    double cycles_per_sec;   // mediana das rodadas
+    double fps;              // mediana das rodadas
+    bench_stat_t frame_ns;
+    bench_stat_t cpu_step_ns;
+    bench_stat_t ppu_step_ns;
+    bench_stat_t ppu_scanline_ns;   // linhas 0-239 com renderização, por linha
+} bench_result_t;
+
+// ======================
+// Estatística
+// ======================
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Ordena samples no lugar
+static bench_stat_t stat_of(double *samples, int n) {
+    bench_stat_t s = { 0, 0 };
+    if (n <= 0) return s;
+    qsort(samples, (size_t)n, sizeof(double), cmp_double);
+    s.median = samples[(n - 1) / 2];
+    s.p99 = samples[(int)((n - 1) * 0.99 + 0.5)];
+    return s;
+}
+
+// ======================
+// Medições
+// ======================
+static void bench_frames(nes_cpu_t *cpu, const uint8_t *state, size_t state_len,
+                         int frames, int runs, bench_result_t *r) {
+    nes_ppu_t *ppu = cpu->memory->ppu;
+    double *frame_ns = malloc((size_t)frames * runs * sizeof(double));
+    double *run_fps = malloc((size_t)runs * sizeof(double));
+    double *run_hz = malloc((size_t)runs * sizeof(double));
+    if (!frame_ns || !run_fps || !run_hz) {
+        free(frame_ns); free(run_fps); free(run_hz);
+        return;
+    }
+
+    for (int run = 0; run < runs; run++) {
+        state_load(cpu, state, state_len);
+        uint64_t start_cycles = cpu->cycles;
+        uint64_t start = timer_now_ns();
+        uint64_t last = start;
+
+        for (int f = 0; f < frames; f++) {
+            nes_run_frame(cpu, ppu, 1);
+            uint64_t now = timer_now_ns();
+            frame_ns[run * frames + f] = (double)(now - last);
+            last = now;
+        }
+
+        double seconds = (double)(last - start) / 1e9;
+        run_fps[run] = frames / seconds;
+        run_hz[run] = (double)(cpu->cycles - start_cycles) / seconds;
+    }
+
+    r->fps = stat_of(run_fps, runs).median;
+    r->cycles_per_sec = stat_of(run_hz, runs).median;
+    r->frame_ns = stat_of(frame_ns, frames * runs);
+    free(frame_ns);
+    free(run_fps);
+    free(run_hz);
+}
+
+// Mede BENCH_SAMPLES lotes de uma operação; retorna ns por operação.
+// Os micro-benchmarks bagunçam o estado (PPU andando sem a CPU etc.):
+// quem chama restaura o estado no fim.
+static bench_stat_t bench_cpu_step(nes_cpu_t *cpu) {
+    static double samples[BENCH_SAMPLES];
+    for (int s = 0; s < BENCH_SAMPLES; s++) {
+        uint64_t t0 = timer_now_ns();
+        for (int i = 0; i < BENCH_CPU_BATCH; i++) cpu_step(cpu);
+        samples[s] = (double)(timer_now_ns() - t0) / BENCH_CPU_BATCH;
+    }
+    return stat_of(samples, BENCH_SAMPLES);
+}
+
+static bench_stat_t bench_ppu_step(nes_cpu_t *cpu) {
+    static double samples[BENCH_SAMPLES];
+    nes_ppu_t *ppu = cpu->memory->ppu;
+    for (int s = 0; s < BENCH_SAMPLES; s++) {
+        uint64_t t0 = timer_now_ns();
+        for (int i = 0; i < BENCH_PPU_BATCH; i++) ppu_step(ppu, cpu);
+        samples[s] = (double)(timer_now_ns() - t0) / BENCH_PPU_BATCH;
+    }
+    return stat_of(samples, BENCH_SAMPLES);
+}
+
+// Trabalho de renderização: catch-up da PPU sobre as 240 linhas
+// visíveis (341 dots cada), em ns por linha. Entre as amostras a PPU
+// anda sem medir até o dot 0 da linha 0 do frame seguinte, então o
+// VBlank ocioso e a pre-render ficam de fora.
+static bench_stat_t bench_ppu_scanline(nes_cpu_t *cpu) {
+    static double samples[BENCH_LINE_SAMPLES];
+    nes_ppu_t *ppu = cpu->memory->ppu;
+    uint64_t visible = (uint64_t)NES_SCREEN_HEIGHT * PPU_DOTS_PER_SCANLINE / 3;   // em ciclos de CPU
+    for (int s = 0; s < BENCH_LINE_SAMPLES; s++) {
+        do ppu_step(ppu, cpu); while (ppu->scanline != 0 || ppu->cycle != 0);
+        uint64_t t0 = timer_now_ns();
+        ppu_catch_up(ppu, cpu, ppu->cpu_time + visible);
+        samples[s] = (double)(timer_now_ns() - t0) / NES_SCREEN_HEIGHT;
+    }
+    return stat_of(samples, BENCH_LINE_SAMPLES);
+}
+
+static int bench_rom(const char *path, int frames, int runs, int warmup, bench_result_t *r) {
+    nes_rom_t *rom = load_nes_rom(path);
+    if (!rom) return 0;
+
+    nes_memory_t *memory = memory_init(rom);
+    nes_cpu_t *cpu = memory ? cpu_init(memory) : NULL;
+    nes_video_sink_t *video = video_null_create();
+    uint8_t *state = cpu ? malloc(state_size(cpu)) : NULL;
+    if (!state || !video) {
+        free(state);
+        video_free(video);
+        cpu_free(cpu);
+        memory_free(memory);
+        free_nes_rom(rom);
+        return 0;
+    }
+    memory->ppu->video = video;
+
+    memset(r, 0, sizeof(*r));
+    r->path = path;
+    r->mapper = memory->mapper->number;
+
+    for (int f = 0; f < warmup; f++) nes_run_frame(cpu, memory->ppu, 1);
+    size_t state_len = state_save(cpu, state, state_size(cpu));
+
+    bench_frames(cpu, state, state_len, frames, runs, r);
+
+    state_load(cpu, state, state_len);
+    r->cpu_step_ns = bench_cpu_step(cpu);
+    state_load(cpu, state, state_len);
+    r->ppu_step_ns = bench_ppu_step(cpu);
+    state_load(cpu, state, state_len);
+    r->ppu_scanline_ns = bench_ppu_scanline(cpu);
+
+    free(state);
+    video_free(video);
+    cpu_free(cpu);
+    memory_free(memory);
+    free_nes_rom(rom);
+    return 1;
+}
+
+// ======================
+// Saída
+// ======================
+// Caminhos do Windows trazem barras invertidas: escapa o que o JSON exige
+static void print_string_json(FILE *f, const char *str) {
+    fputc('"', f);
+    for (; *str; str++) {
+        if (*str == '"' || *str == '\\') fputc('\\', f);
+        fputc(*str, f);
+    }
+    fputc('"', f);
+}
+
+static void print_stat_json(FILE *f, const char *name, bench_stat_t s, int last) {
+    fprintf(f, "      \"%s\": { \"median\": %.2f, \"p99\": %.2f }%s\n", name, s.median, s.p99, last ? "" : ",");
+}
+
+static int write_json(const char *path, const bench_result_t *results, int count,
+                      int frames, int runs, int warmup) {
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        printf("Erro ao criar %s\n", path);
+        return 0;
+    }
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"cpu_core\": \"%s\",\n", BENCH_CPU_CORE);
+    fprintf(f, "  \"frames\": %d,\n  \"runs\": %d,\n  \"warmup\": %d,\n", frames, runs, warmup);
+    fprintf(f, "  \"roms\": [\n");
+    for (int i = 0; i < count; i++) {
+        const bench_result_t *r = &results[i];
+        fprintf(f, "    {\n");
+        fprintf(f, "      \"rom\": ");
+        print_string_json(f, r->path);
+        fprintf(f, ",\n");
+        fprintf(f, "      \"mapper\": %d,\n", r->mapper);
+        fprintf(f, "      \"cycles_per_sec\": %.0f,\n", r->cycles_per_sec);
+        fprintf(f, "      \"fps\": %.2f,\n", r->fps);
+        print_stat_json(f, "frame_ns", r->frame_ns, 0);
+        print_stat_json(f, "cpu_step_ns", r->cpu_step_ns, 0);
+        print_stat_json(f, "ppu_step_ns", r->ppu_step_ns, 0);
+        print_stat_json(f, "ppu_scanline_ns", r->ppu_scanline_ns, 1);
+        fprintf(f, "    }%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return 1;
+}
+
+static void print_result(const bench_result_t *r) {
+    printf("\n=== %s (mapper %d) ===\n", r->path, r->mapper);
+    printf("  Ciclos/s:   %.2f MHz (%.1fx o NES real)\n", r->cycles_per_sec / 1e6, r->cycles_per_sec / NES_CPU_HZ);
+    printf("  FPS:        %.1f\n", r->fps);
+    printf("  Frame:      mediana %.0f ns, p99 %.0f ns\n", r->frame_ns.median, r->frame_ns.p99);
+    printf("  cpu_step:   mediana %.2f ns, p99 %.2f ns\n", r->cpu_step_ns.median, r->cpu_step_ns.p99);
+    printf("  ppu_step:   mediana %.2f ns, p99 %.2f ns\n", r->ppu_step_ns.median, r->ppu_step_ns.p99);
+    printf("  scanline:   mediana %.2f ns, p99 %.2f ns (linha visível renderizada)\n", r->ppu_scanline_ns.median, r->ppu_scanline_ns.p99);
+}
+
+int main(int argc, char *argv[]) {
+    const char *roms[BENCH_MAX_ROMS];
+    int rom_count = 0;
+    int frames = BENCH_DEFAULT_FRAMES;
+    int runs = BENCH_DEFAULT_RUNS;
+    int warmup = BENCH_DEFAULT_WARMUP;
+    const char *json_path = "bench.json";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmup = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (argv[i][0] != '-' && rom_count < BENCH_MAX_ROMS) {
+            roms[rom_count++] = argv[i];
+        } else {
+            frames = 0;
+            break;
+        }
+    }
+
+    if (frames <= 0 || runs <= 0 || warmup < 0) {
+        printf("Uso: %s [--frames N] [--runs R] [--warmup W] [--json <path>] [rom.nes...]\n", argv[0]);
+        return 1;
+    }
+
+    // Sem ROMs na linha de comando: as que vêm com o projeto
+    if (rom_count == 0) {
+        roms[rom_count++] = "games/test.nes";
+        roms[rom_count++] = "games/marios_bros.nes";
+    }
+
+    // Só erros no meio da medição (NES_LOG ainda manda)
+    log_level = LOG_LEVEL_ERROR;
+    log_init();
+    init_instructions();
+
+    bench_result_t results[BENCH_MAX_ROMS];
+    int count = 0;
+    for (int i = 0; i < rom_count; i++) {
+        if (!bench_rom(roms[i], frames, runs, warmup, &results[count])) {
+            printf("Erro ao rodar %s\n", roms[i]);
+            continue;
+        }
+        print_result(&results[count]);
+        count++;
+    }
+
+    int ok = count == rom_count && write_json(json_path, results, count, frames, runs, warmup);
+    if (ok) printf("\nResultados em %s\n", json_path);
+    log_shutdown();
+    return ok ? 0 : 1;
+}
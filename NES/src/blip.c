@@ -0,0 +1,117 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "blip.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ======================
+// Kernel
+// ======================
+
+// Sinc janelado (Blackman) com corte um pouco abaixo de Nyquist, uma
+// linha por fase fracionária; cada linha é normalizada para somar
+// exatamente 1 << BLIP_KERNEL_BITS (o degrau integrado chega à altura certa)
+static void build_kernel(nes_blip_t *b) {
+    const double cutoff = 0.90;
+    const double half = BLIP_TAPS / 2;
+
+    for (int phase = 0; phase < BLIP_PHASES; phase++) {
+        double frac = (double)phase / BLIP_PHASES;
+        double taps[BLIP_TAPS];
+        double sum = 0;
+
+        for (int i = 0; i < BLIP_TAPS; i++) {
+            double x = i - (half - 1) - frac;
+            double s = x == 0 ? 1.0 : sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+            double w = 0.42 + 0.5 * cos(M_PI * x / half) + 0.08 * cos(2 * M_PI * x / half);
+            taps[i] = fabs(x) < half ? s * w : 0;
+            sum += taps[i];
+        }
+
+        int total = 0;
+        for (int i = 0; i < BLIP_TAPS; i++) {
+            b->kernel[phase][i] = (int16_t)lround(taps[i] / sum * (1 << BLIP_KERNEL_BITS));
+            total += b->kernel[phase][i];
+        }
+        // Erro de arredondamento vai para o tap central
+        b->kernel[phase][(int)half - 1] += (1 << BLIP_KERNEL_BITS) - total;
+    }
+}
+
+// ======================
+// Criação e destruição
+// ======================
+nes_blip_t* blip_new(double clock_rate, int sample_rate, int max_samples) {
+    nes_blip_t *b = calloc(1, sizeof(nes_blip_t));
+    if (!b) return NULL;
+
+    b->size = max_samples;
+    b->buf = calloc((size_t)max_samples + BLIP_TAPS, sizeof(int32_t));
+    if (!b->buf) {
+        free(b);
+        return NULL;
+    }
+
+    blip_set_rates(b, clock_rate, sample_rate);
+    build_kernel(b);
+    blip_clear(b);
+    return b;
+}
+
+void blip_free(nes_blip_t *b) {
+    if (!b) return;
+    free(b->buf);
+    free(b);
+}
+
+void blip_clear(nes_blip_t *b) {
+    b->offset = 0;
+    b->avail = 0;
+    b->integrator = 0;
+    b->dc = 0;
+    memset(b->buf, 0, ((size_t)b->size + BLIP_TAPS) * sizeof(int32_t));
+}
+
+void blip_set_rates(nes_blip_t *b, double clock_rate, double sample_rate) {
+    b->factor = (uint64_t)(sample_rate / clock_rate * 4294967296.0 + 0.5);
+}
+
+// ======================
+// Frames e leitura
+// ======================
+void blip_end_frame(nes_blip_t *b, uint32_t clocks) {
+    b->offset += (uint64_t)clocks * b->factor;
+    b->avail = (int)(b->offset >> 32);
+}
+
+int blip_read_samples(nes_blip_t *b, int16_t *out, int count) {
+    int n = count < b->avail ? count : b->avail;
+    int32_t sum = b->integrator;
+    int32_t dc = b->dc;
+
+    for (int i = 0; i < n; i++) {
+        sum += b->buf[i];
+        int32_t s = sum >> BLIP_KERNEL_BITS;
+
+        // Passa-alta de 1 polo: tira o nível DC do mixer do NES
+        dc += ((s << 8) - dc) >> 10;
+        s -= dc >> 8;
+
+        if (s > 32767) s = 32767;
+        if (s < -32768) s = -32768;
+        out[i] = (int16_t)s;
+    }
+    b->integrator = sum;
+    b->dc = dc;
+
+    // O que sobrou (inclusive a cauda dos kernels) vai para o começo
+    int remain = (int)(b->offset >> 32) - n + BLIP_TAPS;
+    memmove(b->buf, b->buf + n, (size_t)remain * sizeof(int32_t));
+    memset(b->buf + remain, 0, (size_t)n * sizeof(int32_t));
+    b->offset -= (uint64_t)n << 32;
+    b->avail -= n;
+    return n;
+}
@@ -2,8 +2,7 @@
 #include <stdio.h>
 #include "cpu.h"
 #include "memory.h"
-
-#define DEBUG_CPU 1   // 0 = off | 1 = on
+#include "log.h"
 
 // ============================ Helpers ============================
 
@@ -41,6 +40,7 @@ static inline uint16_t addr_absolute_y(nes_cpu_t *cpu) { return fetch16(cpu) + c
 nes_cpu_t* cpu_init(nes_memory_t *memory) {
     nes_cpu_t *cpu = calloc(1, sizeof(nes_cpu_t));
     cpu->memory = memory;   // <<=== importante!
+    memory->cpu = cpu;      // relógio para o catch-up da PPU
     cpu->sp = 0xFD;
     cpu->status = 0x24;
     // PC inicial do Reset
@@ -71,25 +71,82 @@ void cpu_reset(nes_cpu_t *cpu) {
     uint8_t hi = memory_read(cpu->memory, 0xFFFD);
     cpu->pc = ((uint16_t)hi << 8) | lo;
     
-    printf("[CPU] Reset concluído. PC inicial = 0x%04X\n", cpu->pc);
+    LOG_INFO(LOG_CPU, "Reset concluído. PC inicial = 0x%04X", cpu->pc);
 }
 // ============================ Execução ============================
 
-int cpu_step(nes_cpu_t *cpu) {
+// cpu->cycles avança a cada instrução: é o relógio que a PPU usa
+// para se alcançar quando a CPU acessa $2000-$3FFF (catch-up)
+
+#ifndef NES_CPU_GOTO
+// Núcleo por tabela: 1 instrução
+static inline void exec_instruction(nes_cpu_t *cpu) {
+#ifdef NES_PROFILE
+    uint16_t pc = cpu->pc;
+    uint64_t start = cpu->cycles;
+#endif
     uint8_t opcode = memory_read(cpu->memory, cpu->pc++);
-    instruction_t inst = instructions[opcode];
-    
-    if (inst.execute == NULL) {
-        printf("[CPU] ERRO: Opcode 0x%02X não implementado em PC=0x%04X\n", opcode, cpu->pc - 1);
-        return 2;
+    cpu->opcode = opcode;
+    const instruction_t *inst = &instructions[opcode];
+
+    inst->execute(cpu, inst->mode);
+    cpu->cycles += inst->cycles;
+    PROFILE_INSTRUCTION(pc, opcode, cpu->cycles - start, cpu->pc, cpu->sp);
+}
+#endif
+
+// Interrupções entram entre instruções (7 ciclos); NMI tem prioridade
+static inline int service_interrupts(nes_cpu_t *cpu) {
+    int nmi = cpu->nmi_pending;
+    if (nmi) {
+        cpu->nmi_pending = 0;
+        cpu_nmi(cpu);
+    } else if (cpu->irq_line && !(cpu->status & FLAG_I)) {
+        cpu_irq(cpu);
+    } else {
+        return 0;
+    }
+    cpu->cycles += 7;
+    PROFILE_INTERRUPT(nmi, cpu->pc, cpu->sp);
+    return 1;
+}
+
+// Executa 1 instrução, ou atende a interrupção pendente
+int cpu_step(nes_cpu_t *cpu) {
+    uint64_t start = cpu->cycles;
+
+    if (!service_interrupts(cpu)) {
+#ifdef NES_CPU_GOTO
+        cpu->run_until = cpu->cycles + 1;
+        cpu_exec_goto(cpu);
+#else
+        exec_instruction(cpu);
+#endif
+    }
+    return (int)(cpu->cycles - start);
+}
+
+int cpu_run(nes_cpu_t *cpu, int budget_cycles) {
+    uint64_t start = cpu->cycles;
+    cpu->run_until = start + budget_cycles;
+
+    while (cpu->cycles < cpu->run_until) {
+        if (service_interrupts(cpu)) continue;
+
+#ifdef NES_CPU_GOTO
+        // Registradores ficam em locais durante todo o lote
+        cpu_exec_goto(cpu);
+#else
+        exec_instruction(cpu);
+#endif
     }
 
-    inst.execute(cpu, inst.mode);
-    return inst.cycles;
+    return (int)(cpu->cycles - start);
 }
 
 void cpu_nmi(nes_cpu_t *cpu) {
     uint16_t pc = cpu->pc;
+    LOG_TRACE(LOG_CPU, "NMI", pc, (uint32_t)cpu->cycles);
 
     // --- empilha PC ---
     // memory_write(cpu->memory, 0x0100 + cpu->sp--, (pc >> 8) & 0xFF); // hi
@@ -112,3 +169,18 @@ void cpu_nmi(nes_cpu_t *cpu) {
     // --- seta flag de interrupção ---
     cpu->status |= 0x04; // set I (disable IRQs durante execução da NMI)
 }
+
+// IRQ (mapper/APU): igual à NMI, mas pelo vetor $FFFE/F
+void cpu_irq(nes_cpu_t *cpu) {
+    uint16_t pc = cpu->pc;
+    LOG_TRACE(LOG_CPU, "IRQ", pc, (uint32_t)cpu->cycles);
+
+    memory_write(cpu->memory, 0x0100 + cpu->sp--, (pc >> 8) & 0xFF); // hi
+    memory_write(cpu->memory, 0x0100 + cpu->sp--, pc & 0xFF);        // lo
+    memory_write(cpu->memory, 0x0100 + cpu->sp--, (cpu->status & ~FLAG_B) | FLAG_U);
+
+    uint8_t lo = memory_read(cpu->memory, 0xFFFE);
+    uint8_t hi = memory_read(cpu->memory, 0xFFFF);
+    cpu->pc = (hi << 8) | lo;
+    cpu->status |= FLAG_I;
+}
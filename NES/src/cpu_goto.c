@@ -0,0 +1,259 @@
+// Núcleo alternativo da CPU com computed goto (labels-as-values do GCC).
+// Cada opcode tem seu próprio handler com o modo de endereçamento já
+// embutido, e o fim de cada handler salta direto para o próximo opcode
+// (threaded code), sem voltar a um switch nem chamar op_* por ponteiro.
+// Ativado no build com -DNES_CPU_GOTO.
+#ifdef NES_CPU_GOTO
+
+#include <stdio.h>
+#include "cpu.h"
+#include "cpu_opcodes.h"
+#include "memory.h"
+#include "log.h"
+
+#define RD(a)     memory_read(mem, (uint16_t)(a))
+#define WR(a, v)  memory_write(mem, (uint16_t)(a), (uint8_t)(v))
+#define PUSH(v)   WR(0x0100 | sp--, (v))
+#define POP()     RD(0x0100 | ++sp)
+
+#define SET_ZN(v) (p = (p & ~(FLAG_Z | FLAG_N)) | ((v) ? 0 : FLAG_Z) | ((v) & FLAG_N))
+
+// ============================ Modos de endereçamento ============================
+// Calculam ea (endereço efetivo) a partir de pc
+#define EA_IMPLIED
+#define EA_ACCUMULATOR
+#define EA_IMMEDIATE   ea = pc++;
+#define EA_ZERO_PAGE   ea = RD(pc++);
+#define EA_ZERO_PAGE_X ea = (uint8_t)(RD(pc++) + x);
+#define EA_ZERO_PAGE_Y ea = (uint8_t)(RD(pc++) + y);
+#define EA_ABSOLUTE    ea = RD(pc) | (RD(pc + 1) << 8); pc += 2;
+#define EA_ABSOLUTE_X  base = RD(pc) | (RD(pc + 1) << 8); ea = (uint16_t)(base + x); pc += 2;
+#define EA_ABSOLUTE_Y  base = RD(pc) | (RD(pc + 1) << 8); ea = (uint16_t)(base + y); pc += 2;
+#define EA_INDIRECT    { uint16_t ptr = RD(pc) | (RD(pc + 1) << 8); pc += 2; \
+                         ea = RD(ptr) | (RD((ptr & 0xFF00) | ((ptr + 1) & 0xFF)) << 8); }
+#define EA_INDIRECT_X  { uint8_t zp = RD(pc++) + x; ea = RD(zp) | (RD((uint8_t)(zp + 1)) << 8); }
+#define EA_INDIRECT_Y  { uint8_t zp = RD(pc++); \
+                         base = RD(zp) | (RD((uint8_t)(zp + 1)) << 8); ea = (uint16_t)(base + y); }
+#define EA_RELATIVE    { int8_t off = (int8_t)RD(pc++); ea = (uint16_t)(pc + off); }
+
+#define IS_ACC_IMPLIED     0
+#define IS_ACC_ACCUMULATOR 1
+#define IS_ACC_IMMEDIATE   0
+#define IS_ACC_ZERO_PAGE   0
+#define IS_ACC_ZERO_PAGE_X 0
+#define IS_ACC_ZERO_PAGE_Y 0
+#define IS_ACC_ABSOLUTE    0
+#define IS_ACC_ABSOLUTE_X  0
+#define IS_ACC_ABSOLUTE_Y  0
+#define IS_ACC_INDIRECT    0
+#define IS_ACC_INDIRECT_X  0
+#define IS_ACC_INDIRECT_Y  0
+#define IS_ACC_RELATIVE    0
+
+// Leituras puras pagam +1 ciclo quando o índice cruza página
+#define CROSS_ABSOLUTE_X ((base ^ ea) > 0xFF)
+#define CROSS_ABSOLUTE_Y ((base ^ ea) > 0xFF)
+#define CROSS_INDIRECT_Y ((base ^ ea) > 0xFF)
+#define CROSS_IMPLIED     0
+#define CROSS_ACCUMULATOR 0
+#define CROSS_IMMEDIATE   0
+#define CROSS_ZERO_PAGE   0
+#define CROSS_ZERO_PAGE_X 0
+#define CROSS_ZERO_PAGE_Y 0
+#define CROSS_ABSOLUTE    0
+#define CROSS_INDIRECT    0
+#define CROSS_INDIRECT_X  0
+#define CROSS_RELATIVE    0
+#define READ_PENALTY(m) if (CROSS_##m) cpu->cycles++;
+
+// ============================ Operações ============================
+// Mesma semântica das op_* de cpu_ops.c, sobre registradores locais
+#define EXEC_LDA(m) READ_PENALTY(m) a = RD(ea); SET_ZN(a);
+#define EXEC_LDX(m) READ_PENALTY(m) x = RD(ea); SET_ZN(x);
+#define EXEC_LDY(m) READ_PENALTY(m) y = RD(ea); SET_ZN(y);
+#define EXEC_STA(m) WR(ea, a);
+#define EXEC_STX(m) WR(ea, x);
+#define EXEC_STY(m) WR(ea, y);
+
+#define EXEC_TAX(m) x = a; SET_ZN(x);
+#define EXEC_TAY(m) y = a; SET_ZN(y);
+#define EXEC_TXA(m) a = x; SET_ZN(a);
+#define EXEC_TYA(m) a = y; SET_ZN(a);
+#define EXEC_TSX(m) x = sp; SET_ZN(x);
+#define EXEC_TXS(m) sp = x;
+
+#define EXEC_JMP(m) pc = ea;
+#define EXEC_JSR(m) { uint16_t ret = pc - 1; PUSH(ret >> 8); PUSH(ret & 0xFF); pc = ea; }
+#define EXEC_RTS(m) { uint8_t lo = POP(); uint8_t hi = POP(); pc = (uint16_t)((lo | (hi << 8)) + 1); }
+#define EXEC_BRK(m) { pc++; PUSH(pc >> 8); PUSH(pc & 0xFF); PUSH(p | FLAG_B | FLAG_U); \
+                      p |= FLAG_I; pc = RD(0xFFFE) | (RD(0xFFFF) << 8); }
+#define EXEC_RTI(m) { p = (POP() & ~FLAG_B) | FLAG_U; uint8_t lo = POP(); uint8_t hi = POP(); \
+                      pc = lo | (hi << 8); }
+
+// Desvio tomado: +1 ciclo, +2 se o destino estiver em outra página
+#define BRANCH(cond) if (cond) { cpu->cycles += ((ea ^ pc) > 0xFF) ? 2 : 1; pc = ea; }
+#define EXEC_BPL(m) BRANCH(!(p & FLAG_N))
+#define EXEC_BMI(m) BRANCH(p & FLAG_N)
+#define EXEC_BVC(m) BRANCH(!(p & FLAG_V))
+#define EXEC_BVS(m) BRANCH(p & FLAG_V)
+#define EXEC_BCC(m) BRANCH(!(p & FLAG_C))
+#define EXEC_BCS(m) BRANCH(p & FLAG_C)
+#define EXEC_BNE(m) BRANCH(!(p & FLAG_Z))
+#define EXEC_BEQ(m) BRANCH(p & FLAG_Z)
+
+#define EXEC_CLC(m) p &= ~FLAG_C;
+#define EXEC_SEC(m) p |= FLAG_C;
+#define EXEC_CLI(m) p &= ~FLAG_I;
+#define EXEC_SEI(m) p |= FLAG_I;
+#define EXEC_CLV(m) p &= ~FLAG_V;
+#define EXEC_CLD(m) p &= ~FLAG_D;
+#define EXEC_SED(m) p |= FLAG_D;
+// NOPs não oficiais com operando fazem a leitura; o implícito não lê
+#define EXEC_NOP(m) NOP_READ_##m
+#define NOP_READ_IMPLIED
+#define NOP_READ_IMMEDIATE   (void)RD(ea);
+#define NOP_READ_ZERO_PAGE   (void)RD(ea);
+#define NOP_READ_ZERO_PAGE_X (void)RD(ea);
+#define NOP_READ_ABSOLUTE    (void)RD(ea);
+#define NOP_READ_ABSOLUTE_X  READ_PENALTY(ABSOLUTE_X) (void)RD(ea);
+
+#define ADC_VALUE(val) { uint8_t v_ = (val); uint16_t r_ = a + v_ + (p & FLAG_C); \
+                         p &= ~(FLAG_C | FLAG_V); \
+                         if (r_ > 0xFF) p |= FLAG_C; \
+                         if ((a ^ r_) & (v_ ^ r_) & 0x80) p |= FLAG_V; \
+                         a = (uint8_t)r_; SET_ZN(a); }
+#define EXEC_ADC(m) READ_PENALTY(m) ADC_VALUE(RD(ea))
+#define EXEC_SBC(m) READ_PENALTY(m) ADC_VALUE(RD(ea) ^ 0xFF)
+
+#define EXEC_AND(m) READ_PENALTY(m) a &= RD(ea); SET_ZN(a);
+#define EXEC_ORA(m) READ_PENALTY(m) a |= RD(ea); SET_ZN(a);
+#define EXEC_EOR(m) READ_PENALTY(m) a ^= RD(ea); SET_ZN(a);
+
+#define COMPARE(reg) { uint8_t v_ = RD(ea); p &= ~FLAG_C; if ((reg) >= v_) p |= FLAG_C; \
+                       SET_ZN((uint8_t)((reg) - v_)); }
+#define EXEC_CMP(m) READ_PENALTY(m) COMPARE(a)
+#define EXEC_CPX(m) COMPARE(x)
+#define EXEC_CPY(m) COMPARE(y)
+
+#define EXEC_INC(m) { uint8_t v_ = RD(ea) + 1; WR(ea, v_); SET_ZN(v_); }
+#define EXEC_DEC(m) { uint8_t v_ = RD(ea) - 1; WR(ea, v_); SET_ZN(v_); }
+#define EXEC_INX(m) x++; SET_ZN(x);
+#define EXEC_INY(m) y++; SET_ZN(y);
+#define EXEC_DEX(m) x--; SET_ZN(x);
+#define EXEC_DEY(m) y--; SET_ZN(y);
+
+// Shifts: acumulador ou memória (decidido em tempo de compilação)
+#define SHIFT(m, expr_c, expr_v) \
+    if (IS_ACC_##m) { uint8_t v_ = a; p = (p & ~FLAG_C) | (expr_c); a = (expr_v); SET_ZN(a); } \
+    else { uint8_t v_ = RD(ea); p = (p & ~FLAG_C) | (expr_c); v_ = (expr_v); WR(ea, v_); SET_ZN(v_); }
+#define EXEC_ASL(m) SHIFT(m, (v_ >> 7), (uint8_t)(v_ << 1))
+#define EXEC_LSR(m) SHIFT(m, (v_ & 1), (uint8_t)(v_ >> 1))
+#define EXEC_ROL(m) { uint8_t c_ = p & FLAG_C; SHIFT(m, (v_ >> 7), (uint8_t)((v_ << 1) | c_)) }
+#define EXEC_ROR(m) { uint8_t c_ = (p & FLAG_C) << 7; SHIFT(m, (v_ & 1), (uint8_t)((v_ >> 1) | c_)) }
+
+#define EXEC_PHA(m) PUSH(a);
+#define EXEC_PLA(m) a = POP(); SET_ZN(a);
+#define EXEC_PHP(m) PUSH(p | FLAG_B | FLAG_U);
+#define EXEC_PLP(m) p = (POP() & ~FLAG_B) | FLAG_U;
+
+#define EXEC_BIT(m) { uint8_t v_ = RD(ea); \
+                      p = (p & ~(FLAG_Z | FLAG_V | FLAG_N)) | (v_ & (FLAG_V | FLAG_N)) | ((a & v_) ? 0 : FLAG_Z); }
+
+// ============================ Não oficiais ============================
+#define EXEC_LAX(m) READ_PENALTY(m) a = x = RD(ea); SET_ZN(a);
+#define EXEC_SAX(m) WR(ea, a & x);
+#define EXEC_LAS(m) READ_PENALTY(m) a = x = sp = RD(ea) & sp; SET_ZN(a);
+
+#define EXEC_DCP(m) { uint8_t m_ = RD(ea) - 1; WR(ea, m_); \
+                      p = (p & ~FLAG_C) | (a >= m_ ? FLAG_C : 0); SET_ZN((uint8_t)(a - m_)); }
+#define EXEC_ISC(m) { uint8_t m_ = RD(ea) + 1; WR(ea, m_); ADC_VALUE(m_ ^ 0xFF) }
+#define EXEC_SLO(m) { uint8_t m_ = RD(ea); p = (p & ~FLAG_C) | (m_ >> 7); m_ <<= 1; \
+                      WR(ea, m_); a |= m_; SET_ZN(a); }
+#define EXEC_RLA(m) { uint8_t m_ = RD(ea), c_ = p & FLAG_C; p = (p & ~FLAG_C) | (m_ >> 7); \
+                      m_ = (uint8_t)((m_ << 1) | c_); WR(ea, m_); a &= m_; SET_ZN(a); }
+#define EXEC_SRE(m) { uint8_t m_ = RD(ea); p = (p & ~FLAG_C) | (m_ & 1); m_ >>= 1; \
+                      WR(ea, m_); a ^= m_; SET_ZN(a); }
+#define EXEC_RRA(m) { uint8_t m_ = RD(ea), c_ = (p & FLAG_C) << 7; p = (p & ~FLAG_C) | (m_ & 1); \
+                      m_ = (m_ >> 1) | c_; WR(ea, m_); ADC_VALUE(m_) }
+
+#define EXEC_ANC(m) a &= RD(ea); SET_ZN(a); p = (p & ~FLAG_C) | (a >> 7);
+#define EXEC_ALR(m) a &= RD(ea); p = (p & ~FLAG_C) | (a & 1); a >>= 1; SET_ZN(a);
+#define EXEC_ARR(m) a = ((a & RD(ea)) >> 1) | ((p & FLAG_C) << 7); SET_ZN(a); \
+                    p = (p & ~(FLAG_C | FLAG_V)) | ((a >> 6) & 1) | ((((a >> 6) ^ (a >> 5)) & 1) << 6);
+#define EXEC_AXS(m) { uint8_t m_ = RD(ea), ax_ = a & x; \
+                      p = (p & ~FLAG_C) | (ax_ >= m_ ? FLAG_C : 0); x = ax_ - m_; SET_ZN(x); }
+#define EXEC_XAA(m) a = x & RD(ea); SET_ZN(a);
+
+// Stores instáveis: valor AND (high byte do endereço base + 1)
+#define HIGH_PLUS_1 ((uint8_t)((base >> 8) + 1))
+#define EXEC_AHX(m) WR(ea, a & x & HIGH_PLUS_1);
+#define EXEC_SHY(m) WR(ea, y & HIGH_PLUS_1);
+#define EXEC_SHX(m) WR(ea, x & HIGH_PLUS_1);
+#define EXEC_TAS(m) sp = a & x; WR(ea, sp & HIGH_PLUS_1);
+
+// A CPU trava no opcode até o reset (o lote termina pelo orçamento)
+#define EXEC_JAM(m) pc--;
+
+// ============================ Loop de execução ============================
+
+// Executa instruções até cpu->cycles chegar a cpu->run_until ou até
+// haver uma interrupção a atender (quem chama atende e volta).
+// cpu->cycles é atualizado a cada instrução: acessos à PPU no meio do
+// lote dependem dele.
+void cpu_exec_goto(nes_cpu_t *cpu) {
+    // Registradores em variáveis locais durante todo o lote
+    nes_memory_t *mem = cpu->memory;
+    uint8_t a = cpu->a, x = cpu->x, y = cpu->y, sp = cpu->sp, p = cpu->status;
+    uint16_t pc = cpu->pc;
+    uint16_t ea = 0, base = 0;
+    uint8_t opcode;
+#ifdef NES_PROFILE
+    uint16_t op_pc = 0;
+    uint64_t op_start = 0;
+#define PROFILE_BEGIN() (op_pc = pc, op_start = cpu->cycles)
+#else
+#define PROFILE_BEGIN() ((void)0)
+#endif
+
+    // Tabela de labels, montada na primeira chamada (cpu_opcodes.h cobre
+    // os 256 opcodes)
+    static void *dispatch[256];
+    if (!dispatch[0]) {
+#define OP(code, name, fn, mode, bytes, cyc) dispatch[code] = &&op_##code;
+        CPU_OPCODES(OP)
+#undef OP
+    }
+
+#define NEXT() do { \
+        if (cpu->cycles >= cpu->run_until || cpu->nmi_pending || \
+            (cpu->irq_line && !(p & FLAG_I))) goto done; \
+        PROFILE_BEGIN(); \
+        cpu->opcode = opcode = RD(pc++); \
+        goto *dispatch[opcode]; \
+    } while (0)
+
+    NEXT();
+
+#define OP(code, name, fn, mode, bytes, cyc) \
+    op_##code: \
+        EA_##mode \
+        EXEC_##name(mode) \
+        cpu->cycles += cyc; \
+        PROFILE_INSTRUCTION(op_pc, code, cpu->cycles - op_start, pc, sp); \
+        NEXT();
+    CPU_OPCODES(OP)
+#undef OP
+
+done:
+    cpu->a = a;
+    cpu->x = x;
+    cpu->y = y;
+    cpu->sp = sp;
+    cpu->status = p;
+    cpu->pc = pc;
+    (void)ea;
+    (void)base;
+#undef PROFILE_BEGIN
+}
+
+#endif
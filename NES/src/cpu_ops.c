@@ -5,56 +5,48 @@
 
 // === Funções auxiliares ===
 
-// Lê valor conforme modo de endereçamento
-static uint8_t read_operand(nes_cpu_t *cpu, addr_mode_t mode, uint16_t *addr_out) {
-    uint8_t value = 0;
-    uint16_t lo, hi, addr;
+// Calcula o endereço efetivo conforme modo de endereçamento; *crossed
+// indica se o índice (X/Y) atravessou uma página (pode ser NULL)
+static uint16_t effective_address(nes_cpu_t *cpu, addr_mode_t mode, int *crossed) {
+    uint16_t lo, hi, base, addr = 0;
 
     switch (mode) {
     case IMMEDIATE:
-        value = memory_read(cpu->memory, cpu->pc++);
+        addr = cpu->pc++;
         break;
 
     case ZERO_PAGE:
         addr = memory_read(cpu->memory, cpu->pc++);
-        if (addr_out) *addr_out = addr;
-        value = memory_read(cpu->memory, addr);
         break;
 
     case ZERO_PAGE_X:
         addr = (memory_read(cpu->memory, cpu->pc++) + cpu->x) & 0xFF;
-        if (addr_out) *addr_out = addr;
-        value = memory_read(cpu->memory, addr);
         break;
 
     case ZERO_PAGE_Y:
         addr = (memory_read(cpu->memory, cpu->pc++) + cpu->y) & 0xFF;
-        if (addr_out) *addr_out = addr;
-        value = memory_read(cpu->memory, addr);
         break;
 
     case ABSOLUTE:
         lo = memory_read(cpu->memory, cpu->pc++);
         hi = memory_read(cpu->memory, cpu->pc++);
         addr = lo | (hi << 8);
-        if (addr_out) *addr_out = addr;
-        value = memory_read(cpu->memory, addr);
         break;
 
     case ABSOLUTE_X:
         lo = memory_read(cpu->memory, cpu->pc++);
         hi = memory_read(cpu->memory, cpu->pc++);
-        addr = (lo | (hi << 8)) + cpu->x;
-        if (addr_out) *addr_out = addr;
-        value = memory_read(cpu->memory, addr);
+        base = lo | (hi << 8);
+        addr = base + cpu->x;
+        if (crossed) *crossed = (base ^ addr) > 0xFF;
         break;
 
     case ABSOLUTE_Y:
         lo = memory_read(cpu->memory, cpu->pc++);
         hi = memory_read(cpu->memory, cpu->pc++);
-        addr = (lo | (hi << 8)) + cpu->y;
-        if (addr_out) *addr_out = addr;
-        value = memory_read(cpu->memory, addr);
+        base = lo | (hi << 8);
+        addr = base + cpu->y;
+        if (crossed) *crossed = (base ^ addr) > 0xFF;
         break;
 
     case INDIRECT:
@@ -67,8 +59,6 @@ static uint8_t read_operand(nes_cpu_t *cpu, addr_mode_t mode, uint16_t *addr_out
             uint16_t hi_ptr = memory_read(cpu->memory, (addr & 0xFF00) | ((addr + 1) & 0xFF));
             addr = lo_ptr | (hi_ptr << 8);
         }
-        if (addr_out) *addr_out = addr;
-        value = memory_read(cpu->memory, addr);
         break;
 
     case INDIRECT_X:
@@ -79,8 +69,6 @@ static uint8_t read_operand(nes_cpu_t *cpu, addr_mode_t mode, uint16_t *addr_out
             uint16_t hi_ptr = memory_read(cpu->memory, (ptr + 1) & 0xFF);
             addr = lo_ptr | (hi_ptr << 8);
         }
-        if (addr_out) *addr_out = addr;
-        value = memory_read(cpu->memory, addr);
         break;
 
     case INDIRECT_Y:
@@ -88,18 +76,16 @@ static uint8_t read_operand(nes_cpu_t *cpu, addr_mode_t mode, uint16_t *addr_out
             uint8_t zp_addr = memory_read(cpu->memory, cpu->pc++);
             uint16_t lo_ptr = memory_read(cpu->memory, zp_addr);
             uint16_t hi_ptr = memory_read(cpu->memory, (zp_addr + 1) & 0xFF);
-            addr = (lo_ptr | (hi_ptr << 8)) + cpu->y;
+            base = lo_ptr | (hi_ptr << 8);
+            addr = base + cpu->y;
+            if (crossed) *crossed = (base ^ addr) > 0xFF;
         }
-        if (addr_out) *addr_out = addr;
-        value = memory_read(cpu->memory, addr);
         break;
 
     case RELATIVE:
         {
             int8_t offset = (int8_t)memory_read(cpu->memory, cpu->pc++);
             addr = cpu->pc + offset;
-            if (addr_out) *addr_out = addr;
-            value = 0; // branches não leem valor
         }
         break;
 
@@ -107,7 +93,25 @@ static uint8_t read_operand(nes_cpu_t *cpu, addr_mode_t mode, uint16_t *addr_out
         break;
     }
 
-    return value;
+    return addr;
+}
+
+static inline uint16_t operand_address(nes_cpu_t *cpu, addr_mode_t mode) {
+    return effective_address(cpu, mode, NULL);
+}
+
+// Lê valor conforme modo de endereçamento. Leitura pura (addr_out NULL)
+// paga +1 ciclo ao cruzar página; read-modify-write e stores já têm o
+// ciclo extra fixo na tabela.
+static uint8_t read_operand(nes_cpu_t *cpu, addr_mode_t mode, uint16_t *addr_out) {
+    int crossed = 0;
+    uint16_t addr = effective_address(cpu, mode, &crossed);
+    if (addr_out) *addr_out = addr;
+    else if (crossed) cpu->cycles++;
+
+    // branches e JMP não leem valor (evita efeito colateral em registradores de I/O)
+    if (mode == RELATIVE || mode == INDIRECT || mode == IMPLIED || mode == ACCUMULATOR) return 0;
+    return memory_read(cpu->memory, addr);
 }
 
 // Atualiza flags Z/N
@@ -152,21 +156,20 @@ void op_ldy(nes_cpu_t *cpu, addr_mode_t mode) {
     set_zn_flags(cpu, cpu->y);
 }
 
+// Store só precisa do endereço: ler antes teria efeito colateral
+// em registradores como $2007
 void op_sta(nes_cpu_t *cpu, addr_mode_t mode) {
-    uint16_t addr = 0;
-    read_operand(cpu, mode, &addr);
+    uint16_t addr = operand_address(cpu, mode);
     memory_write(cpu->memory, addr, cpu->a);
 }
 
 void op_stx(nes_cpu_t *cpu, addr_mode_t mode) {
-    uint16_t addr = 0;
-    read_operand(cpu, mode, &addr);
+    uint16_t addr = operand_address(cpu, mode);
     memory_write(cpu->memory, addr, cpu->x);
 }
 
 void op_sty(nes_cpu_t *cpu, addr_mode_t mode) {
-    uint16_t addr = 0;
-    read_operand(cpu, mode, &addr);
+    uint16_t addr = operand_address(cpu, mode);
     memory_write(cpu->memory, addr, cpu->y);
 }
 
@@ -388,14 +391,11 @@ void op_ror(nes_cpu_t *cpu, addr_mode_t mode) {
 
 // --- JUMPS ---
 void op_jmp(nes_cpu_t *cpu, addr_mode_t mode) {
-    uint16_t addr = 0;
-    read_operand(cpu, mode, &addr);
-    cpu->pc = addr;
+    cpu->pc = operand_address(cpu, mode);
 }
 
 void op_jsr(nes_cpu_t *cpu, addr_mode_t mode) {
-    uint16_t addr = 0;
-    read_operand(cpu, mode, &addr);
+    uint16_t addr = operand_address(cpu, mode);
     
     // Push return address - 1 (RTS adiciona 1)
     uint16_t ret_addr = cpu->pc - 1;
@@ -412,85 +412,26 @@ void op_rts(nes_cpu_t *cpu, addr_mode_t mode) {
 }
 
 // --- BRANCHES ---
-void op_bpl(nes_cpu_t *cpu, addr_mode_t mode) {
-    if (!(cpu->status & FLAG_N)) {
-        uint16_t addr = 0;
-        read_operand(cpu, mode, &addr);
-        cpu->pc = addr;
-    } else {
-        cpu->pc++; // pula o operando
-    }
-}
 
-void op_bmi(nes_cpu_t *cpu, addr_mode_t mode) {
-    if (cpu->status & FLAG_N) {
-        uint16_t addr = 0;
-        read_operand(cpu, mode, &addr);
-        cpu->pc = addr;
-    } else {
-        cpu->pc++;
-    }
-}
-
-void op_bvc(nes_cpu_t *cpu, addr_mode_t mode) {
-    if (!(cpu->status & FLAG_V)) {
-        uint16_t addr = 0;
-        read_operand(cpu, mode, &addr);
-        cpu->pc = addr;
-    } else {
-        cpu->pc++;
-    }
-}
-
-void op_bvs(nes_cpu_t *cpu, addr_mode_t mode) {
-    if (cpu->status & FLAG_V) {
-        uint16_t addr = 0;
-        read_operand(cpu, mode, &addr);
-        cpu->pc = addr;
-    } else {
-        cpu->pc++;
-    }
-}
-
-void op_bcc(nes_cpu_t *cpu, addr_mode_t mode) {
-    if (!(cpu->status & FLAG_C)) {
-        uint16_t addr = 0;
-        read_operand(cpu, mode, &addr);
-        cpu->pc = addr;
-    } else {
-        cpu->pc++;
-    }
-}
-
-void op_bcs(nes_cpu_t *cpu, addr_mode_t mode) {
-    if (cpu->status & FLAG_C) {
-        uint16_t addr = 0;
-        read_operand(cpu, mode, &addr);
-        cpu->pc = addr;
-    } else {
-        cpu->pc++;
-    }
-}
-
-void op_bne(nes_cpu_t *cpu, addr_mode_t mode) {
-    if (!(cpu->status & FLAG_Z)) {
-        uint16_t addr = 0;
-        read_operand(cpu, mode, &addr);
-        cpu->pc = addr;
-    } else {
-        cpu->pc++;
+// Desvio tomado: +1 ciclo, +2 se o destino estiver em outra página
+static inline void branch(nes_cpu_t *cpu, addr_mode_t mode, int taken) {
+    if (!taken) {
+        cpu->pc++; // pula o operando
+        return;
     }
+    uint16_t target = operand_address(cpu, mode);
+    cpu->cycles += ((target ^ cpu->pc) > 0xFF) ? 2 : 1;
+    cpu->pc = target;
 }
 
-void op_beq(nes_cpu_t *cpu, addr_mode_t mode) {
-    if (cpu->status & FLAG_Z) {
-        uint16_t addr = 0;
-        read_operand(cpu, mode, &addr);
-        cpu->pc = addr;
-    } else {
-        cpu->pc++;
-    }
-}
+void op_bpl(nes_cpu_t *cpu, addr_mode_t mode) { branch(cpu, mode, !(cpu->status & FLAG_N)); }
+void op_bmi(nes_cpu_t *cpu, addr_mode_t mode) { branch(cpu, mode, cpu->status & FLAG_N); }
+void op_bvc(nes_cpu_t *cpu, addr_mode_t mode) { branch(cpu, mode, !(cpu->status & FLAG_V)); }
+void op_bvs(nes_cpu_t *cpu, addr_mode_t mode) { branch(cpu, mode, cpu->status & FLAG_V); }
+void op_bcc(nes_cpu_t *cpu, addr_mode_t mode) { branch(cpu, mode, !(cpu->status & FLAG_C)); }
+void op_bcs(nes_cpu_t *cpu, addr_mode_t mode) { branch(cpu, mode, cpu->status & FLAG_C); }
+void op_bne(nes_cpu_t *cpu, addr_mode_t mode) { branch(cpu, mode, !(cpu->status & FLAG_Z)); }
+void op_beq(nes_cpu_t *cpu, addr_mode_t mode) { branch(cpu, mode, cpu->status & FLAG_Z); }
 
 // --- FLAGS ---
 void op_clc(nes_cpu_t *cpu, addr_mode_t mode) {
@@ -580,5 +521,177 @@ void op_bit(nes_cpu_t *cpu, addr_mode_t mode) {
 
 // --- MISC ---
 void op_nop(nes_cpu_t *cpu, addr_mode_t mode) {
-    // Do nothing
+    // NOPs não oficiais com operando ainda fazem a leitura (e pagam o
+    // cruzamento de página); no modo implícito não lê nada
+    read_operand(cpu, mode, NULL);
+}
+
+//
+// ==== Instruções não oficiais ====
+//
+
+// Soma usada por ADC/SBC e pelas combinações RRA/ISC
+static void add_with_carry(nes_cpu_t *cpu, uint8_t value) {
+    uint16_t result = cpu->a + value + (cpu->status & FLAG_C);
+
+    cpu->status &= ~(FLAG_C | FLAG_V);
+    if (result > 0xFF) cpu->status |= FLAG_C;
+    if ((cpu->a ^ result) & (value ^ result) & 0x80) cpu->status |= FLAG_V;
+
+    cpu->a = result & 0xFF;
+    set_zn_flags(cpu, cpu->a);
+}
+
+// High byte do endereço base + 1 (stores instáveis AHX/SHX/SHY/TAS)
+static uint8_t base_high_plus_1(uint16_t addr, uint8_t index) {
+    return (uint8_t)(((uint16_t)(addr - index) >> 8) + 1);
+}
+
+// --- LOAD/STORE COMBINADOS ---
+void op_lax(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint8_t value = read_operand(cpu, mode, NULL);
+    cpu->a = value;
+    cpu->x = value;
+    set_zn_flags(cpu, value);
+}
+
+void op_sax(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint16_t addr = operand_address(cpu, mode);
+    memory_write(cpu->memory, addr, cpu->a & cpu->x);
+}
+
+void op_las(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint8_t value = read_operand(cpu, mode, NULL) & cpu->sp;
+    cpu->a = value;
+    cpu->x = value;
+    cpu->sp = value;
+    set_zn_flags(cpu, value);
+}
+
+// --- READ-MODIFY-WRITE + ALU ---
+void op_dcp(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint16_t addr = 0;
+    uint8_t value = read_operand(cpu, mode, &addr) - 1;
+    memory_write(cpu->memory, addr, value);
+
+    cpu->status &= ~FLAG_C;
+    if (cpu->a >= value) cpu->status |= FLAG_C;
+    set_zn_flags(cpu, cpu->a - value);
+}
+
+void op_isc(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint16_t addr = 0;
+    uint8_t value = read_operand(cpu, mode, &addr) + 1;
+    memory_write(cpu->memory, addr, value);
+    add_with_carry(cpu, value ^ 0xFF);
+}
+
+void op_slo(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint16_t addr = 0;
+    uint8_t value = read_operand(cpu, mode, &addr);
+    cpu->status = (cpu->status & ~FLAG_C) | ((value & 0x80) ? FLAG_C : 0);
+    value <<= 1;
+    memory_write(cpu->memory, addr, value);
+    cpu->a |= value;
+    set_zn_flags(cpu, cpu->a);
+}
+
+void op_rla(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint16_t addr = 0;
+    uint8_t value = read_operand(cpu, mode, &addr);
+    uint8_t carry = (cpu->status & FLAG_C) ? 1 : 0;
+    cpu->status = (cpu->status & ~FLAG_C) | ((value & 0x80) ? FLAG_C : 0);
+    value = (value << 1) | carry;
+    memory_write(cpu->memory, addr, value);
+    cpu->a &= value;
+    set_zn_flags(cpu, cpu->a);
+}
+
+void op_sre(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint16_t addr = 0;
+    uint8_t value = read_operand(cpu, mode, &addr);
+    cpu->status = (cpu->status & ~FLAG_C) | ((value & 0x01) ? FLAG_C : 0);
+    value >>= 1;
+    memory_write(cpu->memory, addr, value);
+    cpu->a ^= value;
+    set_zn_flags(cpu, cpu->a);
+}
+
+void op_rra(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint16_t addr = 0;
+    uint8_t value = read_operand(cpu, mode, &addr);
+    uint8_t carry = (cpu->status & FLAG_C) ? 0x80 : 0;
+    cpu->status = (cpu->status & ~FLAG_C) | ((value & 0x01) ? FLAG_C : 0);
+    value = (value >> 1) | carry;
+    memory_write(cpu->memory, addr, value);
+    add_with_carry(cpu, value);
+}
+
+// --- IMEDIATOS ---
+void op_anc(nes_cpu_t *cpu, addr_mode_t mode) {
+    cpu->a &= read_operand(cpu, mode, NULL);
+    set_zn_flags(cpu, cpu->a);
+    cpu->status = (cpu->status & ~FLAG_C) | ((cpu->a & 0x80) ? FLAG_C : 0);
+}
+
+void op_alr(nes_cpu_t *cpu, addr_mode_t mode) {
+    cpu->a &= read_operand(cpu, mode, NULL);
+    cpu->status = (cpu->status & ~FLAG_C) | ((cpu->a & 0x01) ? FLAG_C : 0);
+    cpu->a >>= 1;
+    set_zn_flags(cpu, cpu->a);
+}
+
+void op_arr(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint8_t carry = (cpu->status & FLAG_C) ? 0x80 : 0;
+    cpu->a = ((cpu->a & read_operand(cpu, mode, NULL)) >> 1) | carry;
+    set_zn_flags(cpu, cpu->a);
+
+    // C = bit 6, V = bit 6 xor bit 5 do resultado
+    cpu->status &= ~(FLAG_C | FLAG_V);
+    if (cpu->a & 0x40) cpu->status |= FLAG_C;
+    if (((cpu->a >> 6) ^ (cpu->a >> 5)) & 1) cpu->status |= FLAG_V;
+}
+
+void op_axs(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint8_t value = read_operand(cpu, mode, NULL);
+    uint8_t ax = cpu->a & cpu->x;
+
+    cpu->status &= ~FLAG_C;
+    if (ax >= value) cpu->status |= FLAG_C;
+    cpu->x = ax - value;
+    set_zn_flags(cpu, cpu->x);
+}
+
+void op_xaa(nes_cpu_t *cpu, addr_mode_t mode) {
+    // Instável; constante "mágica" $FF, a variante mais comum
+    cpu->a = cpu->x & read_operand(cpu, mode, NULL);
+    set_zn_flags(cpu, cpu->a);
+}
+
+// --- STORES COM HIGH BYTE ---
+void op_ahx(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint16_t addr = operand_address(cpu, mode);
+    memory_write(cpu->memory, addr, cpu->a & cpu->x & base_high_plus_1(addr, cpu->y));
+}
+
+void op_shy(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint16_t addr = operand_address(cpu, mode);
+    memory_write(cpu->memory, addr, cpu->y & base_high_plus_1(addr, cpu->x));
+}
+
+void op_shx(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint16_t addr = operand_address(cpu, mode);
+    memory_write(cpu->memory, addr, cpu->x & base_high_plus_1(addr, cpu->y));
+}
+
+void op_tas(nes_cpu_t *cpu, addr_mode_t mode) {
+    uint16_t addr = operand_address(cpu, mode);
+    cpu->sp = cpu->a & cpu->x;
+    memory_write(cpu->memory, addr, cpu->sp & base_high_plus_1(addr, cpu->y));
+}
+
+// --- JAM ---
+void op_jam(nes_cpu_t *cpu, addr_mode_t mode) {
+    // A CPU trava: o PC fica parado no opcode até o reset
+    cpu->pc--;
 }
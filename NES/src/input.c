@@ -0,0 +1,47 @@
+#include <stdlib.h>
+#include "input.h"
+#include "log.h"
+
+// Bits 5-7 da leitura não vêm do controle: ficam com o open bus, que
+// quase sempre é o byte alto do endereço ($40). Alguns jogos conferem.
+#define INPUT_OPEN_BUS 0x40
+
+nes_input_t* input_init(void) {
+    return calloc(1, sizeof(nes_input_t));
+}
+
+void input_free(nes_input_t *input) {
+    free(input);
+}
+
+void input_set(nes_input_t *input, int port, uint8_t buttons) {
+    if (port < 0 || port >= INPUT_PORTS) return;
+
+    // Direções opostas juntas não existem no controle de verdade e
+    // travam alguns jogos: cancela o par
+    if ((buttons & (INPUT_UP | INPUT_DOWN)) == (INPUT_UP | INPUT_DOWN)) buttons &= ~(INPUT_UP | INPUT_DOWN);
+    if ((buttons & (INPUT_LEFT | INPUT_RIGHT)) == (INPUT_LEFT | INPUT_RIGHT)) buttons &= ~(INPUT_LEFT | INPUT_RIGHT);
+
+    input->buttons[port] = buttons;
+
+    // Com o strobe ligado o registrador acompanha os botões o tempo todo
+    if (input->strobe) input->shift[port] = buttons;
+}
+
+// Strobe 1: os registradores recarregam continuamente; a descida para 0
+// congela o estado atual, que as leituras vão tirando bit a bit
+void input_write(nes_input_t *input, uint8_t value) {
+    input->strobe = value & 1;
+    if (input->strobe) {
+        for (int port = 0; port < INPUT_PORTS; port++) input->shift[port] = input->buttons[port];
+    }
+    LOG_DEBUG(LOG_INPUT, "Strobe %d (botões %02X %02X)", input->strobe, input->buttons[0], input->buttons[1]);
+}
+
+uint8_t input_read(nes_input_t *input, int port) {
+    uint8_t bit = input->shift[port] & 1;
+
+    // Depois dos 8 botões o controle oficial devolve 1 (entra 1 no topo)
+    if (!input->strobe) input->shift[port] = (uint8_t)((input->shift[port] >> 1) | 0x80);
+    return INPUT_OPEN_BUS | bit;
+}
@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include "log.h"
+#include "timer.h"
+
+#define LOG_RING_SIZE 1024   // potência de 2
+#define LOG_MSG_LEN   120
+
+int log_level = LOG_LEVEL_INFO;
+uint32_t log_mask = LOG_ALL;
+
+// Slot do ring: seq controla quem pode usar (fila limitada MPSC)
+typedef struct {
+    atomic_uint_fast64_t seq;
+    uint64_t time_ns;
+    uint8_t level;
+    uint32_t sys;
+    const char *tag;          // != NULL: evento de trace binário
+    uint32_t a, b;
+    char msg[LOG_MSG_LEN];
+} log_slot_t;
+
+static log_slot_t ring[LOG_RING_SIZE];
+static atomic_uint_fast64_t ring_tail;   // próxima posição a reservar
+static uint64_t ring_head;               // próxima posição a ler (só a thread)
+static atomic_uint_fast64_t dropped;
+
+static pthread_t writer;
+static atomic_int running;
+static int started;
+static uint64_t start_ns;
+
+static const char *level_names[] = { "", "ERRO", "AVISO", "INFO", "DEBUG", "TRACE" };
+
+static const struct { const char *name; uint32_t bit; } sys_names[] = {
+    { "cpu", LOG_CPU }, { "ppu", LOG_PPU }, { "mmu", LOG_MMU },
+    { "video", LOG_VIDEO }, { "apu", LOG_APU }, { "input", LOG_INPUT },
+    { "all", LOG_ALL },
+};
+
+static const char* sys_name(uint32_t sys) {
+    for (size_t i = 0; i < sizeof(sys_names) / sizeof(sys_names[0]) - 1; i++) {
+        if (sys & sys_names[i].bit) return sys_names[i].name;
+    }
+    return "?";
+}
+
+// ======================
+// Configuração
+// ======================
+static void parse_env(void) {
+    const char *level = getenv("NES_LOG");
+    if (level) {
+        for (int i = LOG_LEVEL_NONE; i <= LOG_LEVEL_TRACE; i++) {
+            const char *names[] = { "none", "error", "warn", "info", "debug", "trace" };
+            if (strcmp(level, names[i]) == 0) log_level = i;
+        }
+    }
+
+    const char *sys = getenv("NES_LOG_SYS");
+    if (sys) {
+        log_mask = 0;
+        for (size_t i = 0; i < sizeof(sys_names) / sizeof(sys_names[0]); i++) {
+            if (strstr(sys, sys_names[i].name)) log_mask |= sys_names[i].bit;
+        }
+    }
+}
+
+// ======================
+// Escrita (thread)
+// ======================
+static void print_slot(const log_slot_t *slot) {
+    double t = (double)(slot->time_ns - start_ns) / 1e6;
+    if (slot->tag) {
+        printf("[%10.3f] [%s] %s %08X %08X\n", t, sys_name(slot->sys), slot->tag, slot->a, slot->b);
+    } else {
+        printf("[%10.3f] [%s] %s: %s\n", t, sys_name(slot->sys), level_names[slot->level], slot->msg);
+    }
+}
+
+// Consome tudo o que já foi publicado; retorna quantas mensagens saíram
+static int drain(void) {
+    int count = 0;
+    for (;;) {
+        log_slot_t *slot = &ring[ring_head & (LOG_RING_SIZE - 1)];
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != ring_head + 1) break;
+        print_slot(slot);
+        atomic_store_explicit(&slot->seq, ring_head + LOG_RING_SIZE, memory_order_release);
+        ring_head++;
+        count++;
+    }
+
+    uint64_t lost = atomic_exchange(&dropped, 0);
+    if (lost) printf("[LOG] %llu mensagens descartadas (ring cheio)\n", (unsigned long long)lost);
+    if (count || lost) fflush(stdout);
+    return count;
+}
+
+static void* writer_main(void *arg) {
+    (void)arg;
+    struct timespec nap = { 0, 5 * 1000 * 1000 }; // 5 ms
+
+    while (atomic_load(&running)) {
+        if (!drain()) nanosleep(&nap, NULL);
+    }
+    drain();
+    return NULL;
+}
+
+// ======================
+// Produtores
+// ======================
+
+// Reserva um slot; NULL se o ring estiver cheio
+static log_slot_t* reserve(uint64_t *pos_out) {
+    uint64_t pos = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+    for (;;) {
+        log_slot_t *slot = &ring[pos & (LOG_RING_SIZE - 1)];
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int64_t diff = (int64_t)(seq - pos);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring_tail, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                *pos_out = pos;
+                return slot;
+            }
+        } else if (diff < 0) {
+            atomic_fetch_add(&dropped, 1);
+            return NULL;
+        } else {
+            pos = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+        }
+    }
+}
+
+static void publish(log_slot_t *slot, uint64_t pos) {
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+}
+
+void log_write(int level, uint32_t sys, const char *fmt, ...) {
+    va_list args;
+
+    // Sem thread de escrita: direto no stdout
+    if (!started) {
+        va_start(args, fmt);
+        printf("[%s] %s: ", sys_name(sys), level_names[level]);
+        vprintf(fmt, args);
+        printf("\n");
+        va_end(args);
+        return;
+    }
+
+    uint64_t pos;
+    log_slot_t *slot = reserve(&pos);
+    if (!slot) return;
+
+    slot->time_ns = timer_now_ns();
+    slot->level = (uint8_t)level;
+    slot->sys = sys;
+    slot->tag = NULL;
+    va_start(args, fmt);
+    vsnprintf(slot->msg, sizeof(slot->msg), fmt, args);
+    va_end(args);
+    publish(slot, pos);
+}
+
+void log_trace_event(uint32_t sys, const char *tag, uint32_t a, uint32_t b) {
+    if (!started) {
+        printf("[%s] %s %08X %08X\n", sys_name(sys), tag, a, b);
+        return;
+    }
+
+    uint64_t pos;
+    log_slot_t *slot = reserve(&pos);
+    if (!slot) return;
+
+    slot->time_ns = timer_now_ns();
+    slot->level = LOG_LEVEL_TRACE;
+    slot->sys = sys;
+    slot->tag = tag;
+    slot->a = a;
+    slot->b = b;
+    publish(slot, pos);
+}
+
+// ======================
+// Init / shutdown
+// ======================
+void log_init(void) {
+    if (started) return;
+    parse_env();
+
+    for (uint64_t i = 0; i < LOG_RING_SIZE; i++) atomic_store(&ring[i].seq, i);
+    atomic_store(&ring_tail, 0);
+    ring_head = 0;
+    start_ns = timer_now_ns();
+
+    atomic_store(&running, 1);
+    if (pthread_create(&writer, NULL, writer_main, NULL) != 0) {
+        printf("[LOG] Erro ao criar thread de log, escrevendo direto\n");
+        return;
+    }
+    started = 1;
+}
+
+void log_shutdown(void) {
+    if (!started) return;
+    atomic_store(&running, 0);
+    pthread_join(writer, NULL);
+    started = 0;
+}
@@ -1,21 +1,138 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#ifndef NES_HEADLESS
 #include <SDL2/SDL.h>
+#endif
 #include "rom.h"
 #include "cpu.h"
 #include "memory.h"
 #include "ppu.h"
+#include "video.h"
+#include "audio.h"
+#include "timer.h"
+#include "rewind.h"
+#include "movie.h"
+#include "profile.h"
+#include "nes.h"
+#include "log.h"
+
+#define HEADLESS_DEFAULT_FRAMES 600
+#define REWIND_BYTES_PER_SECOND (64 * 1024) // folga: ~32 KB/s medidos
+
+// Entrega as amostras do frame ao backend de áudio. Com backend de
+// relógio próprio (SDL) é aqui que a emulação segura o ritmo: dorme se
+// o buffer passou do alvo e ajusta a taxa do próximo frame pelo nível.
+static void audio_frame(nes_apu_t *apu, nes_audio_sink_t *audio) {
+    audio_write(audio, apu->samples, apu->sample_count);
+    audio_wait(audio);
+    apu_set_rate_ratio(apu, audio_rate_ratio(audio));
+}
+
+// Um frame, com o movie (gravação/replay, pode ser NULL) em volta
+static void run_frame(nes_cpu_t *cpu, nes_ppu_t *ppu, nes_movie_t *movie, int present) {
+    movie_before_frame(movie, cpu);
+    nes_run_frame(cpu, ppu, present);
+    movie_after_frame(movie, cpu);
+}
+
+// Um passo do loop em tempo real: emula os frames que o fast-forward
+// pula (sem vídeo e sem áudio) e depois um frame apresentado.
+// speed 0 = sem limite: pula frames até dar o tempo de um frame real,
+// assim a tela continua sendo atualizada a ~60 Hz.
+static void run_step(nes_cpu_t *cpu, nes_ppu_t *ppu, nes_movie_t *movie, int speed) {
+    if (speed == 0) {
+        uint64_t until = timer_now_ns() + NES_FRAME_NS;
+        while (timer_now_ns() < until) run_frame(cpu, ppu, movie, 0);
+    } else {
+        for (int i = 1; i < speed; i++) run_frame(cpu, ppu, movie, 0);
+    }
+    run_frame(cpu, ppu, movie, 1);
+}
+
+// Roda N frames sem janela e mede a vazão (baseline de desempenho).
+// Com um movie em replay, roda o movie inteiro e confere os hashes.
+static void run_headless(nes_cpu_t *cpu, nes_ppu_t *ppu, nes_audio_sink_t *audio, nes_movie_t *movie, int frames) {
+    if (movie && !movie->recording) frames = movie->count;
+    int start_frame = ppu->frame;
+    uint64_t start_cycles = cpu->cycles;
+    uint64_t start = timer_now_ns();
+
+    while (ppu->frame - start_frame < frames) {
+        run_frame(cpu, ppu, movie, 1);
+        audio_frame(cpu->memory->apu, audio);
+    }
+
+    double seconds = (double)(timer_now_ns() - start) / 1e9;
+    uint64_t cycles = cpu->cycles - start_cycles;
+    double hz = seconds > 0 ? cycles / seconds : 0.0;
+    printf("\n=== Headless ===\n");
+    printf("  Frames emulados: %d\n", frames);
+    printf("  Ciclos de CPU: %llu (%.1f por frame)\n", (unsigned long long)cycles, frames > 0 ? (double)cycles / frames : 0.0);
+    printf("  Tempo total: %.3f s\n", seconds);
+    printf("  FPS emulado: %.1f\n", seconds > 0 ? frames / seconds : 0.0);
+    printf("  Ciclos/s: %.2f MHz (%.1fx o NES real)\n", hz / 1e6, hz / NES_CPU_HZ);
+    if (movie && !movie->recording) {
+        if (movie->mismatches) printf("  Movie: %d frames divergentes (primeiro: %d)\n", movie->mismatches, movie->first_mismatch);
+        else printf("  Movie: %d frames conferidos, todos iguais\n", movie->count);
+    }
+}
 
 int main(int argc, char *argv[]) {
-    if (argc != 2) {
-        printf("Uso: %s <rom.nes>\n", argv[0]);
+    const char *rom_path = NULL;
+#ifdef NES_HEADLESS
+    int headless = 1;
+#else
+    int headless = 0;
+#endif
+    int frames = HEADLESS_DEFAULT_FRAMES;
+    const char *video_spec = NULL;
+    const char *audio_spec = NULL;
+    int video_thread = 0;
+    int speed = 1;          // fast-forward: 1, 2, 4... ou 0 (max) = sem limite
+    int rewind_seconds = 0; // 0 = sem rewind
+    const char *record_path = NULL;
+    const char *replay_path = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            headless = 1;
+        } else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--video") == 0 && i + 1 < argc) {
+            video_spec = argv[++i];
+        } else if (strcmp(argv[i], "--audio") == 0 && i + 1 < argc) {
+            audio_spec = argv[++i];
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            speed = strcmp(argv[++i], "max") == 0 ? 0 : atoi(argv[i]);
+        } else if (strcmp(argv[i], "--rewind") == 0 && i + 1 < argc) {
+            rewind_seconds = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--video-thread") == 0) {
+            video_thread = 1;
+        } else if (!rom_path) {
+            rom_path = argv[i];
+        } else {
+            rom_path = NULL;
+            break;
+        }
+    }
+
+    if (!rom_path || frames <= 0 || speed < 0 || rewind_seconds < 0 || (record_path && replay_path)) {
+        printf("Uso: %s <rom.nes> [--headless] [--frames N] [--video sdl|null|file:<path>|shm:<nome>] [--video-thread] [--audio sdl|null|file:<path.wav>] [--speed 1|2|4|max] [--rewind segundos] [--record|--replay <movie>]\n", argv[0]);
         return 1;
     }
 
+    log_init();
+
     // Carregar ROM
-    nes_rom_t *rom = load_nes_rom(argv[1]);
+    nes_rom_t *rom = load_nes_rom(rom_path);
     if (!rom) {
         printf("Erro ao carregar ROM!\n");
+        log_shutdown();
         return 1;
     }
 
@@ -32,74 +149,111 @@ int main(int argc, char *argv[]) {
     init_instructions(); // Inicializa tabela de instruções
 
     printf("[CPU] Reset concluído. PC inicial = 0x%04X\n\n", cpu->pc);
-    printf("=== Executando ROM: %s ===\n\n", argv[1]);
-
-    // ======================
-    // TESTE: Popular a nametable manualmente via PPUADDR/PPUDATA
-    // ======================
-    printf("=== Testando escrita manual na PPU ===\n");
-
-    uint16_t nametable_addr = 0x2000; // primeira nametable
-
-    printf("1\n");
-    
-    // Preencher a nametable inteira com tile 1
-    memory_write(memory, 0x2006, (nametable_addr >> 8) & 0xFF); // high byte
-    memory_write(memory, 0x2006, nametable_addr & 0xFF);        // low byte
-    for (int i = 0; i < 960; i++) { // 32*30 tiles
-        memory_write(memory, 0x2007, 1);
+    printf("=== Executando ROM: %s ===\n\n", rom_path);
+
+    // Backend de vídeo: sem janela no modo headless
+    if (!video_spec) video_spec = headless ? "null" : "sdl";
+    nes_video_sink_t *video = video_create(video_spec);
+    if (video && video_thread) video = video_threaded_create(video);
+    if (!video || !video_init(video)) {
+        video_free(video);
+        cpu_free(cpu);
+        memory_free(memory);
+        free_nes_rom(rom);
+        log_shutdown();
+        return 1;
     }
+    memory->ppu->video = video;
 
-    printf("2\n");
+    // Backend de áudio; a APU passa a gerar na taxa que ele abriu
+    if (!audio_spec) audio_spec = headless ? "null" : "sdl";
+    nes_audio_sink_t *audio = audio_create(audio_spec, APU_SAMPLE_RATE);
+    if (!audio || !audio_init(audio)) {
+        audio_free(audio);
+        video_free(video);
+        cpu_free(cpu);
+        memory_free(memory);
+        free_nes_rom(rom);
+        log_shutdown();
+        return 1;
+    }
+    if (audio->sample_rate != memory->apu->sample_rate) apu_set_sample_rate(memory->apu, audio->sample_rate);
 
-    // Primeira linha com tile 2
-    memory_write(memory, 0x2006, (nametable_addr >> 8) & 0xFF);
-    memory_write(memory, 0x2006, nametable_addr & 0xFF);
-    for (int i = 0; i < 32; i++) {
-        memory_write(memory, 0x2007, 2);
+    // Movie: começa daqui (o estado até este ponto é sempre o mesmo)
+    nes_movie_t *movie = NULL;
+    if (record_path) movie = movie_record(cpu, record_path);
+    if (replay_path) movie = movie_replay(cpu, replay_path);
+    if ((record_path || replay_path) && !movie) {
+        audio_free(audio);
+        video_free(video);
+        cpu_free(cpu);
+        memory_free(memory);
+        free_nes_rom(rom);
+        log_shutdown();
+        return 1;
     }
 
-    printf("3\n");
+    if (headless) {
+        run_headless(cpu, memory->ppu, audio, movie, frames);
+    } else {
+        // ======================
+        // Loop em tempo real até o backend pedir para sair
+        // ======================
+        // Quem marca o ritmo: o relógio do áudio, se o backend tiver um
+        // (audio_wait dorme até o buffer baixar), senão o pacer a
+        // 60,0988 Hz. No fast-forward só o frame apresentado manda
+        // amostras, então o mesmo ritmo de 60 apresentações/s vira
+        // speed vezes a velocidade normal; sem limite, nada espera.
+        int audio_clock = audio->queued != NULL;
+        timer_pacer_t pacer;
+        timer_pacer_start(&pacer, NES_FRAME_NS);
 
-    // Segunda linha com tile 3
-    uint16_t second_line = nametable_addr + 32;
-    memory_write(memory, 0x2006, (second_line >> 8) & 0xFF);
-    memory_write(memory, 0x2006, second_line & 0xFF);
-    for (int i = 0; i < 32; i++) {
-        memory_write(memory, 0x2007, 3);
-    }
+        // Rewind (tecla do backend): um snapshot por passo do loop
+        nes_rewind_t *rw = NULL;
+        if (rewind_seconds > 0) rw = rewind_init(cpu, rewind_seconds, (size_t)rewind_seconds * REWIND_BYTES_PER_SECOND);
+        uint8_t hotkeys = 0;
 
-    // Renderiza para testar
-    ppu_render(memory->ppu);
-
-    // ======================
-    // Loop para manter a janela aberta
-    // ======================
-    SDL_Event event;
-    int running = 1;
-    while (running) {
-        int cpu_cycles = cpu_step(cpu);        // executa 1 instrução
-        int ppu_cycles = cpu_cycles * 3;       // PPU anda 3x mais rápido
-        
-        for (int i = 0; i < ppu_cycles; i++) {
-            ppu_step(memory->ppu, cpu);        // passa ppu + cpu
-        }
-        
-        // Renderiza 1 vez por frame
-        if (memory->ppu->scanline == 0 && memory->ppu->cycle == 0) {
-            ppu_render(memory->ppu);
-        }
-    
-        // SDL eventos para fechar janela
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) running = 0;
+        int running = 1;
+        while (running) {
+            if (rw && (hotkeys & VIDEO_HOTKEY_REWIND)) {
+                // Volta um passo: carrega o snapshot anterior e emula o
+                // frame seguinte a ele só para ter imagem e som
+                if (rewind_pop(rw, cpu)) run_frame(cpu, memory->ppu, movie, 1);
+            } else {
+                run_step(cpu, memory->ppu, movie, speed);
+                if (rw) rewind_push(rw, cpu);
+            }
+
+            if (speed == 0) {
+                audio_write(audio, memory->apu->samples, memory->apu->sample_count);
+            } else {
+                audio_frame(memory->apu, audio);
+                if (!audio_clock) timer_pacer_wait(&pacer);
+            }
+
+            // Eventos da janela 1 vez por frame apresentado; o teclado
+            // vira o snapshot do controle 1 para os próximos frames
+            if (video_should_quit(video)) running = 0;
+            input_set(memory->input, 0, video_buttons(video));
+            hotkeys = video_hotkeys(video);
         }
+        rewind_free(rw);
     }
 
-    // Liberar recursos
+    // Liberar recursos (a gravação do movie vai para o disco aqui); replay
+    // divergente vira código de saída 2 para scripts de regressão
+    int status = 0;
+    if (movie && !movie->recording && movie->mismatches) status = 2;
+    if (!movie_close(movie)) status = 1;
+#ifdef NES_PROFILE
+    profile_write("nes_profile");
+#endif
+    audio_free(audio);
+    video_free(video);
     cpu_free(cpu);
     memory_free(memory);
     free_nes_rom(rom);
+    log_shutdown();
 
-    return 0;
+    return status;
 }
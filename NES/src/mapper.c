@@ -0,0 +1,378 @@
+#include <stdlib.h>
+#include <string.h>
+#include "mapper.h"
+#include "memory.h"
+#include "log.h"
+
+// ======================
+// Helpers de banco
+// ======================
+
+// Resolve bancos negativos (contados do fim) e faz o wrap pelo tamanho
+static uint32_t bank_offset(int bank, uint32_t bank_size, uint32_t total) {
+    int count = total / bank_size;
+    if (count <= 0) return 0;
+    if (bank < 0) bank += count;
+    bank %= count;
+    if (bank < 0) bank += count;
+    return (uint32_t)bank * bank_size;
+}
+
+void mapper_map_prg_8k(nes_mapper_t *m, int slot, int bank) {
+    uint32_t total = (uint32_t)m->rom->prg_rom_bytes;
+    if (total < 0x2000) return;
+
+    uint8_t *src = m->rom->prg_rom + bank_offset(bank, 0x2000, total);
+    uint8_t **pages = &m->mem->read_page[0x80 + (slot & 3) * 0x20];
+    for (int i = 0; i < 0x20; i++) pages[i] = src + (i << 8);
+}
+
+void mapper_map_prg_16k(nes_mapper_t *m, int slot, int bank) {
+    // 16 KB = 2 bancos de 8 KB consecutivos (NROM-128 espelha pelo wrap)
+    int count = (int)(m->rom->prg_rom_bytes / 0x4000);
+    if (count <= 0) return;
+    if (bank < 0) bank += count;
+    bank %= count;
+    mapper_map_prg_8k(m, slot * 2, bank * 2);
+    mapper_map_prg_8k(m, slot * 2 + 1, bank * 2 + 1);
+}
+
+void mapper_map_prg_32k(nes_mapper_t *m, int bank) {
+    mapper_map_prg_16k(m, 0, bank * 2);
+    mapper_map_prg_16k(m, 1, bank * 2 + 1);
+}
+
+void mapper_map_chr_1k(nes_mapper_t *m, int slot, int bank) {
+    ppu_set_chr_bank(m->ppu, slot, bank_offset(bank, 0x400, m->ppu->chr_size));
+}
+
+void mapper_map_chr_2k(nes_mapper_t *m, int slot, int bank) {
+    mapper_map_chr_1k(m, slot * 2, bank * 2);
+    mapper_map_chr_1k(m, slot * 2 + 1, bank * 2 + 1);
+}
+
+void mapper_map_chr_4k(nes_mapper_t *m, int slot, int bank) {
+    for (int i = 0; i < 4; i++) mapper_map_chr_1k(m, slot * 4 + i, bank * 4 + i);
+}
+
+void mapper_map_chr_8k(nes_mapper_t *m, int bank) {
+    for (int i = 0; i < 8; i++) mapper_map_chr_1k(m, i, bank * 8 + i);
+}
+
+// ======================
+// 0: NROM
+// ======================
+static void nrom_remap(nes_mapper_t *m) {
+    // 16 KB aparece 2 vezes; 32 KB direto
+    mapper_map_prg_16k(m, 0, 0);
+    mapper_map_prg_16k(m, 1, 1);
+    mapper_map_chr_8k(m, 0);
+}
+
+// ======================
+// 1: MMC1 (SxROM)
+// ======================
+typedef struct {
+    uint8_t shift;      // registrador serial (bit 4 = sentinela)
+    uint8_t control;    // espelhamento, modo PRG, modo CHR
+    uint8_t chr0, chr1, prg;
+} mmc1_t;
+
+static void mmc1_remap(nes_mapper_t *m) {
+    mmc1_t *s = m->ctx;
+
+    static const int mirroring[4] = {
+        PPU_MIRROR_SINGLE_LOW, PPU_MIRROR_SINGLE_HIGH, PPU_MIRROR_VERTICAL, PPU_MIRROR_HORIZONTAL
+    };
+    ppu_set_mirroring(m->ppu, mirroring[s->control & 3]);
+
+    switch ((s->control >> 2) & 3) {
+        case 0:
+        case 1: // 32 KB, ignora bit 0
+            mapper_map_prg_32k(m, (s->prg & 0x0F) >> 1);
+            break;
+        case 2: // $8000 fixo no primeiro, $C000 trocável
+            mapper_map_prg_16k(m, 0, 0);
+            mapper_map_prg_16k(m, 1, s->prg & 0x0F);
+            break;
+        case 3: // $8000 trocável, $C000 fixo no último
+            mapper_map_prg_16k(m, 0, s->prg & 0x0F);
+            mapper_map_prg_16k(m, 1, -1);
+            break;
+    }
+
+    if (s->control & 0x10) {
+        mapper_map_chr_4k(m, 0, s->chr0);
+        mapper_map_chr_4k(m, 1, s->chr1);
+    } else {
+        mapper_map_chr_8k(m, s->chr0 >> 1);
+    }
+}
+
+static void mmc1_write(nes_mapper_t *m, uint16_t addr, uint8_t value) {
+    if (addr < 0x8000) return;
+    mmc1_t *s = m->ctx;
+
+    // Bit 7: reset do registrador serial, PRG volta ao modo 3
+    if (value & 0x80) {
+        s->shift = 0x10;
+        s->control |= 0x0C;
+        mmc1_remap(m);
+        return;
+    }
+
+    int complete = s->shift & 1;
+    s->shift = (s->shift >> 1) | ((value & 1) << 4);
+    if (!complete) return;
+
+    // 5º write: o endereço escolhe o registrador
+    uint8_t data = s->shift;
+    switch ((addr >> 13) & 3) {
+        case 0: s->control = data; break;
+        case 1: s->chr0 = data; break;
+        case 2: s->chr1 = data; break;
+        case 3: s->prg = data; break;
+    }
+    s->shift = 0x10;
+    mmc1_remap(m);
+}
+
+// ======================
+// 2: UxROM
+// ======================
+typedef struct {
+    uint8_t bank;
+} uxrom_t;
+
+static void uxrom_remap(nes_mapper_t *m) {
+    uxrom_t *s = m->ctx;
+    mapper_map_prg_16k(m, 0, s->bank);
+    mapper_map_prg_16k(m, 1, -1);
+    mapper_map_chr_8k(m, 0);
+}
+
+static void uxrom_write(nes_mapper_t *m, uint16_t addr, uint8_t value) {
+    if (addr < 0x8000) return;
+    uxrom_t *s = m->ctx;
+    s->bank = value;
+    mapper_map_prg_16k(m, 0, s->bank);
+}
+
+// ======================
+// 3: CNROM
+// ======================
+typedef struct {
+    uint8_t bank;
+} cnrom_t;
+
+static void cnrom_remap(nes_mapper_t *m) {
+    cnrom_t *s = m->ctx;
+    mapper_map_prg_16k(m, 0, 0);
+    mapper_map_prg_16k(m, 1, 1);
+    mapper_map_chr_8k(m, s->bank);
+}
+
+static void cnrom_write(nes_mapper_t *m, uint16_t addr, uint8_t value) {
+    if (addr < 0x8000) return;
+    cnrom_t *s = m->ctx;
+    s->bank = value;
+    mapper_map_chr_8k(m, s->bank);
+}
+
+// ======================
+// 4: MMC3 (TxROM)
+// ======================
+typedef struct {
+    uint8_t bank_select;   // bits 0-2 = registrador, 6 = modo PRG, 7 = inversão CHR
+    uint8_t regs[8];       // R0-R5 CHR, R6-R7 PRG
+    uint8_t mirroring;
+    uint8_t irq_latch;
+    uint8_t irq_counter;
+    uint8_t irq_reload;
+    uint8_t irq_enabled;
+    uint8_t irq_pending;
+} mmc3_t;
+
+static void mmc3_remap_prg(nes_mapper_t *m) {
+    mmc3_t *s = m->ctx;
+    if (s->bank_select & 0x40) {
+        mapper_map_prg_8k(m, 0, -2);
+        mapper_map_prg_8k(m, 2, s->regs[6]);
+    } else {
+        mapper_map_prg_8k(m, 0, s->regs[6]);
+        mapper_map_prg_8k(m, 2, -2);
+    }
+    mapper_map_prg_8k(m, 1, s->regs[7]);
+    mapper_map_prg_8k(m, 3, -1);
+}
+
+static void mmc3_remap_chr(nes_mapper_t *m) {
+    mmc3_t *s = m->ctx;
+    // Inversão troca as metades $0000 e $1000
+    int inv = (s->bank_select & 0x80) ? 4 : 0;
+    mapper_map_chr_1k(m, 0 ^ inv, s->regs[0] & 0xFE);
+    mapper_map_chr_1k(m, 1 ^ inv, s->regs[0] | 0x01);
+    mapper_map_chr_1k(m, 2 ^ inv, s->regs[1] & 0xFE);
+    mapper_map_chr_1k(m, 3 ^ inv, s->regs[1] | 0x01);
+    mapper_map_chr_1k(m, 4 ^ inv, s->regs[2]);
+    mapper_map_chr_1k(m, 5 ^ inv, s->regs[3]);
+    mapper_map_chr_1k(m, 6 ^ inv, s->regs[4]);
+    mapper_map_chr_1k(m, 7 ^ inv, s->regs[5]);
+}
+
+static void mmc3_remap(nes_mapper_t *m) {
+    mmc3_t *s = m->ctx;
+    mmc3_remap_prg(m);
+    mmc3_remap_chr(m);
+    ppu_set_mirroring(m->ppu, (s->mirroring & 1) ? PPU_MIRROR_HORIZONTAL : PPU_MIRROR_VERTICAL);
+}
+
+static void mmc3_write(nes_mapper_t *m, uint16_t addr, uint8_t value) {
+    if (addr < 0x8000) return;
+    mmc3_t *s = m->ctx;
+
+    // Registradores em pares par/ímpar a cada 8 KB
+    switch (addr & 0xE001) {
+        case 0x8000: {
+            uint8_t changed = s->bank_select ^ value;
+            s->bank_select = value;
+            if (changed & 0x40) mmc3_remap_prg(m);
+            if (changed & 0x80) mmc3_remap_chr(m);
+            break;
+        }
+        case 0x8001: {
+            int r = s->bank_select & 7;
+            s->regs[r] = value;
+            if (r >= 6) mmc3_remap_prg(m);
+            else mmc3_remap_chr(m);
+            break;
+        }
+        case 0xA000:
+            s->mirroring = value;
+            ppu_set_mirroring(m->ppu, (value & 1) ? PPU_MIRROR_HORIZONTAL : PPU_MIRROR_VERTICAL);
+            break;
+        case 0xA001: // proteção da PRG-RAM (ignorada)
+            break;
+        case 0xC000:
+            s->irq_latch = value;
+            break;
+        case 0xC001:
+            s->irq_counter = 0;
+            s->irq_reload = 1;
+            break;
+        case 0xE000:
+            s->irq_enabled = 0;
+            s->irq_pending = 0;
+            break;
+        case 0xE001:
+            s->irq_enabled = 1;
+            break;
+    }
+}
+
+static void mmc3_scanline(nes_mapper_t *m) {
+    mmc3_t *s = m->ctx;
+    if (s->irq_counter == 0 || s->irq_reload) {
+        s->irq_counter = s->irq_latch;
+        s->irq_reload = 0;
+    } else {
+        s->irq_counter--;
+    }
+    if (s->irq_counter == 0 && s->irq_enabled) s->irq_pending = 1;
+}
+
+static int mmc3_irq(nes_mapper_t *m) {
+    mmc3_t *s = m->ctx;
+    return s->irq_pending;
+}
+
+// Mesma conta do mmc3_scanline, feita adiantada
+static int mmc3_irq_clocks(nes_mapper_t *m) {
+    mmc3_t *s = m->ctx;
+    if (!s->irq_enabled || s->irq_pending) return -1;
+    if (s->irq_counter == 0 || s->irq_reload) {
+        // 1º clock recarrega; latch 0 dispara nele mesmo
+        return s->irq_latch == 0 ? 1 : s->irq_latch + 1;
+    }
+    return s->irq_counter;
+}
+
+// ======================
+// Criação
+// ======================
+nes_mapper_t* mapper_create(nes_rom_t *rom, struct nes_memory_t *mem, nes_ppu_t *ppu) {
+    nes_mapper_t *m = calloc(1, sizeof(nes_mapper_t));
+    if (!m) return NULL;
+
+    m->rom = rom;
+    m->mem = mem;
+    m->ppu = ppu;
+    m->number = rom->mapper_number;
+
+    size_t ctx_size = 0;
+    switch (rom->mapper_number) {
+        case 1:
+            m->name = "MMC1";
+            m->remap = mmc1_remap;
+            m->cpu_write = mmc1_write;
+            ctx_size = sizeof(mmc1_t);
+            break;
+        case 2:
+            m->name = "UxROM";
+            m->remap = uxrom_remap;
+            m->cpu_write = uxrom_write;
+            ctx_size = sizeof(uxrom_t);
+            break;
+        case 3:
+            m->name = "CNROM";
+            m->remap = cnrom_remap;
+            m->cpu_write = cnrom_write;
+            ctx_size = sizeof(cnrom_t);
+            break;
+        case 4:
+            m->name = "MMC3";
+            m->remap = mmc3_remap;
+            m->cpu_write = mmc3_write;
+            m->scanline = mmc3_scanline;
+            m->irq = mmc3_irq;
+            m->irq_clocks = mmc3_irq_clocks;
+            ctx_size = sizeof(mmc3_t);
+            break;
+        default:
+            if (rom->mapper_number != 0) {
+                LOG_WARN(LOG_MMU, "Mapper %d não suportado, usando NROM", rom->mapper_number);
+                m->number = 0;
+            }
+            m->name = "NROM";
+            m->remap = nrom_remap;
+            break;
+    }
+
+    if (ctx_size) {
+        m->ctx = calloc(1, ctx_size);
+        if (!m->ctx) {
+            free(m);
+            return NULL;
+        }
+        m->ctx_size = ctx_size;
+    }
+
+    // Estado de power-on
+    if (m->number == 1) {
+        mmc1_t *s = m->ctx;
+        s->shift = 0x10;
+        s->control = 0x0C;
+    } else if (m->number == 4) {
+        mmc3_t *s = m->ctx;
+        s->mirroring = rom->mirroring ? 0 : 1;
+    }
+
+    LOG_INFO(LOG_MMU, "Mapper %d (%s)", m->number, m->name);
+    return m;
+}
+
+void mapper_free(nes_mapper_t *m) {
+    if (!m) return;
+    free(m->ctx);
+    free(m);
+}
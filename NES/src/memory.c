@@ -4,6 +4,8 @@
 #include <string.h>
 #include "memory.h"
 #include "ppu.h"
+#include "cpu.h"
+#include "log.h"
 
 // ==== Inicialização e liberação ====
 nes_memory_t* memory_init(nes_rom_t *rom) {
@@ -19,80 +21,200 @@ nes_memory_t* memory_init(nes_rom_t *rom) {
         return NULL;
     }
 
+    mem->apu = apu_init(mem, APU_SAMPLE_RATE);
+    if (!mem->apu) {
+        ppu_free(mem->ppu);
+        free(mem);
+        return NULL;
+    }
+
+    mem->input = input_init();
+    if (!mem->input) {
+        apu_free(mem->apu);
+        ppu_free(mem->ppu);
+        free(mem);
+        return NULL;
+    }
+
+    mem->mapper = mapper_create(rom, mem, mem->ppu);
+    if (!mem->mapper) {
+        input_free(mem->input);
+        apu_free(mem->apu);
+        ppu_free(mem->ppu);
+        free(mem);
+        return NULL;
+    }
+    mem->ppu->mapper = mem->mapper;
+
     // Zera RAM interna
     memset(mem->ram, 0, sizeof(mem->ram));
 
+    memory_map_rebuild(mem);
     return mem;
 }
 
 void memory_free(nes_memory_t *mem) {
     if (!mem) return;
     if (mem->ppu) ppu_free(mem->ppu);
+    apu_free(mem->apu);
+    input_free(mem->input);
+    mapper_free(mem->mapper);
     free(mem);
 }
 
-// ==== Leitura de memória ====
-uint8_t memory_read(nes_memory_t *mem, uint16_t addr) {
-    if (addr < 0x2000) {
-        // RAM interna (espelhada a cada 0x800 bytes)
-        return mem->ram[addr % 0x800];
+// ==== Mapa de páginas ====
+void memory_map_rebuild(nes_memory_t *mem) {
+    memset(mem->read_page, 0, sizeof(mem->read_page));
+    memset(mem->write_page, 0, sizeof(mem->write_page));
+
+    // $0000-$1FFF: 2 KB de RAM espelhados 4 vezes
+    for (int page = 0x00; page < 0x20; page++) {
+        mem->read_page[page] = &mem->ram[(page & 0x07) << 8];
+        mem->write_page[page] = mem->read_page[page];
+    }
+
+    // $6000-$7FFF: PRG-RAM
+    for (int page = 0x60; page < 0x80; page++) {
+        mem->read_page[page] = &mem->prg_ram[(page - 0x60) << 8];
+        mem->write_page[page] = mem->read_page[page];
     }
-    else if (addr >= 0x2000 && addr <= 0x3FFF) {
+
+    // $8000-$FFFF: bancos de PRG-ROM do mapper, só leitura (writes vão
+    // para os registradores do mapper pelo caminho lento)
+    if (mem->rom->prg_rom_bytes < 0x2000) {
+        LOG_WARN(LOG_MMU, "Tamanho PRG-ROM inesperado: %zu bytes", mem->rom->prg_rom_bytes);
+    }
+    if (mem->mapper) mem->mapper->remap(mem->mapper);
+}
+
+// Ciclo de CPU em que o acesso acontece. cpu->cycles é o início da
+// instrução em curso (os ciclos dela só são somados no fim; o ciclo
+// extra de página cruzada já entrou), o acesso cai no ciclo read_cycle
+// ou write_cycle dela (cpu.h)
+static inline uint64_t access_cycle(nes_memory_t *mem, int write) {
+    const instruction_t *inst = &instructions[mem->cpu->opcode];
+    return mem->cpu->cycles + (write ? inst->write_cycle : inst->read_cycle);
+}
+
+// Traz a PPU até o ciclo do acesso antes de ler/escrever $2000-$3FFF
+static inline void ppu_sync(nes_memory_t *mem, int write) {
+    if (mem->cpu) ppu_catch_up(mem->ppu, mem->cpu, access_cycle(mem, write));
+}
+
+// Idem para a APU antes de um acesso a $4000-$4017
+static inline void apu_sync(nes_memory_t *mem, int write) {
+    if (mem->cpu) apu_catch_up(mem->apu, access_cycle(mem, write));
+}
+
+// ==== Leitura de memória (páginas sem ponteiro direto) ====
+uint8_t memory_read_io(nes_memory_t *mem, uint16_t addr) {
+    if (addr >= 0x2000 && addr <= 0x3FFF) {
         // PPU registers (espelhados a cada 8 bytes)
+        ppu_sync(mem, 0);
         return ppu_read(mem->ppu, 0x2000 + (addr % 8));
     }
-    else if (addr >= 0x4000 && addr <= 0x4017) {
-        // APU/Input registers (stub)
-        return 0;
+    else if (addr == 0x4015) {
+        apu_sync(mem, 0);
+        return apu_read(mem->apu, addr);
     }
-    else if (addr >= 0x4020 && addr <= 0x7FFF) {
-        // Expansion ROM (normalmente não usada)
+    else if (addr == 0x4016 || addr == 0x4017) {
+        // Controles: só consomem o snapshot do frame (input.h)
+        return input_read(mem->input, addr & 1);
+    }
+    else if (addr >= 0x4000 && addr <= 0x4017) {
+        // Registradores só de escrita
         return 0;
     }
-    else if (addr >= 0x8000) {
-        // PRG-ROM
-        if (mem->rom->prg_rom_bytes == 0x4000) {
-            // ROM de 16KB → espelhada (NROM-128)
-            return mem->prg_rom[(addr - 0x8000) % 0x4000];
-        } else if (mem->rom->prg_rom_bytes == 0x8000) {
-            // ROM de 32KB → direto
-            return mem->prg_rom[addr - 0x8000];
-        } else {
-            printf("[MMU] Tamanho PRG-ROM inesperado: %zu bytes\n", mem->rom->prg_rom_bytes);
-            return 0;
-        }
+    else if (addr >= 0x4020 && mem->mapper->cpu_read) {
+        return mem->mapper->cpu_read(mem->mapper, addr);
     }
     else {
-        // Não mapeado
+        // Expansion ROM / não mapeado
         return 0;
     }
 }
 
-// ==== Escrita de memória ====
-void memory_write(nes_memory_t *mem, uint16_t addr, uint8_t value) {
-    if (addr < 0x2000) {
-        // RAM interna (espelhada a cada 0x800 bytes)
-        mem->ram[addr % 0x800] = value;
+// ==== DMA de sprites ($4014) ====
+int memory_oam_dma(nes_memory_t *mem, uint8_t page) {
+    nes_ppu_t *ppu = mem->ppu;
+    const uint8_t *src = mem->read_page[page];
+
+    // A avaliação de sprites da scanline atual usa a OAM antiga
+    ppu_sync(mem, 1);
+
+    if (src) {
+        // RAM/PRG: a página é contígua, cópia em bloco a partir de OAMADDR
+        uint8_t start = ppu->oamaddr;
+        memcpy(&ppu->oam[start], src, 256 - start);
+        if (start) memcpy(ppu->oam, src + (256 - start), start);
+    } else {
+        // Página de I/O (raro): byte a byte, como o hardware faria
+        for (int i = 0; i < 256; i++) {
+            ppu_write(ppu, 0x2004, memory_read_io(mem, (uint16_t)((page << 8) | i)));
+        }
     }
-    else if (addr >= 0x2000 && addr <= 0x3FFF) {
+    LOG_DEBUG(LOG_MMU, "DMA $%02X00 -> OAM", page);
+
+    // 513 ciclos, +1 se o DMA começar num ciclo ímpar: ele começa no
+    // ciclo seguinte ao write em $4014 (qualquer modo de STA/STX/STY)
+    if (!mem->cpu) return 513;
+    return 513 + (int)((access_cycle(mem, 1) + 1) & 1);
+}
+
+// ==== Escrita de memória (páginas sem ponteiro direto) ====
+void memory_write_io(nes_memory_t *mem, uint16_t addr, uint8_t value) {
+    if (addr >= 0x2000 && addr <= 0x3FFF) {
         // PPU (espelhada a cada 8 registradores)
+        ppu_sync(mem, 1);
+        LOG_TRACE(LOG_PPU, "PPU_W", addr, value);
         ppu_write(mem->ppu, 0x2000 + (addr % 8), value);
+
+        // NMI ligada durante o VBlank: avisa a CPU já, sem esperar o próximo catch-up
+        if (mem->ppu->nmi_pending && mem->cpu) {
+            mem->ppu->nmi_pending = 0;
+            mem->cpu->nmi_pending = 1;
+        }
+
+        // PPUCTRL/PPUMASK mudam o dot de A12 e se há renderização:
+        // a previsão do IRQ do mapper precisa ser refeita
+        if (mem->cpu && mem->mapper->irq_clocks && (addr & 7) <= 1) cpu_yield(mem->cpu);
     }
     else if (addr >= 0x4000 && addr <= 0x4017) {
         if (addr == 0x4014) {
-            // DMA OAM
-            printf("[MMU] DMA $%02X00 solicitado\n", value);
+            // DMA OAM: a CPU fica parada enquanto os 256 bytes são copiados
+            int stall = memory_oam_dma(mem, value);
+            if (mem->cpu) mem->cpu->cycles += stall;
+        } else if (addr == 0x4016) {
+            input_write(mem->input, value);
+        } else {
+            apu_sync(mem, 1);
+            apu_write(mem->apu, addr, value);
+
+            // Frame counter/DMC mudaram: refaz a previsão de IRQ da APU
+            if (mem->cpu && (addr == 0x4010 || addr == 0x4015 || addr == 0x4017)) cpu_yield(mem->cpu);
+        }
+    }
+    else if (addr >= 0x4020 && mem->mapper->cpu_write) {
+        // Registradores do mapper: a PPU precisa estar em dia antes de
+        // trocar CHR/espelhamento no meio do frame
+        ppu_sync(mem, 1);
+        mem->mapper->cpu_write(mem->mapper, addr, value);
+
+        // Latch/ack/enable de IRQ: atualiza a linha e refaz a previsão
+        if (mem->cpu && mem->mapper->irq) {
+            cpu_set_irq(mem->cpu, CPU_IRQ_MAPPER, mem->mapper->irq(mem->mapper));
+            cpu_yield(mem->cpu);
         }
     }
     else if (addr >= 0x4020 && addr <= 0x7FFF) {
         // Expansion ROM
-        printf("[MMU] Write Expansion $%04X=%02X (ignorado)\n", addr, value);
+        LOG_DEBUG(LOG_MMU, "Write Expansion $%04X=%02X (ignorado)", addr, value);
     }
     else if (addr >= 0x8000) {
         // PRG-ROM é somente leitura
-        printf("[MMU] Tentativa de escrita na ROM $%04X=%02X (ignorado)\n", addr, value);
+        LOG_DEBUG(LOG_MMU, "Tentativa de escrita na ROM $%04X=%02X (ignorado)", addr, value);
     }
     else {
-        printf("[MMU] Escrita em área não mapeada $%04X=%02X\n", addr, value);
+        LOG_WARN(LOG_MMU, "Escrita em área não mapeada $%04X=%02X", addr, value);
     }
 }
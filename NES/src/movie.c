@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "movie.h"
+#include "memory.h"
+#include "log.h"
+
+// Hash de 64 bits palavra a palavra (FNV-1a em blocos de 8 bytes com
+// mistura final): ~30 mil palavras por framebuffer, barato por frame
+static uint64_t hash_words(const void *data, size_t size, uint64_t h) {
+    const uint8_t *p = data;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, sizeof(w));
+        h = (h ^ w) * 0x100000001B3ull;
+    }
+    for (; i < size; i++) h = (h ^ p[i]) * 0x100000001B3ull;
+    return h;
+}
+
+static uint64_t hash_finish(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return h;
+}
+
+#define HASH_SEED 0xCBF29CE484222325ull
+
+static uint64_t frame_hash(nes_memory_t *mem) {
+    uint64_t h = hash_words(mem->ppu->framebuffer, sizeof(mem->ppu->framebuffer), HASH_SEED);
+    h = hash_words(mem->ram, sizeof(mem->ram), h);
+    return hash_finish(h);
+}
+
+static void fill_header(movie_header_t *h, nes_memory_t *mem) {
+    memset(h, 0, sizeof(*h));
+    h->magic = MOVIE_MAGIC;
+    h->version = MOVIE_VERSION;
+    h->mapper = (uint16_t)mem->mapper->number;
+    h->prg_banks = mem->rom->prg_rom_size;
+    h->rom_hash = hash_finish(hash_words(mem->rom->prg_rom, mem->rom->prg_rom_bytes, HASH_SEED));
+}
+
+static nes_movie_t* movie_alloc(nes_cpu_t *cpu, const char *path, int recording) {
+    nes_movie_t *movie = calloc(1, sizeof(nes_movie_t));
+    if (!movie) return NULL;
+    movie->path = strdup(path);
+    fill_header(&movie->header, cpu->memory);
+    movie->recording = recording;
+    movie->start_frame = cpu->memory->ppu->frame;
+    movie->first_mismatch = -1;
+    return movie;
+}
+
+static void movie_free(nes_movie_t *movie) {
+    free(movie->frames);
+    free(movie->path);
+    free(movie);
+}
+
+// ======================
+// Abertura
+// ======================
+nes_movie_t* movie_record(nes_cpu_t *cpu, const char *path) {
+    return movie_alloc(cpu, path, 1);
+}
+
+nes_movie_t* movie_replay(nes_cpu_t *cpu, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        LOG_ERROR(LOG_INPUT, "Erro ao abrir movie %s", path);
+        return NULL;
+    }
+
+    nes_movie_t *movie = movie_alloc(cpu, path, 0);
+    movie_header_t h;
+    int ok = movie && fread(&h, sizeof(h), 1, f) == 1 &&
+             h.magic == MOVIE_MAGIC && h.version == MOVIE_VERSION;
+    if (!ok) {
+        LOG_ERROR(LOG_INPUT, "Movie inválido: %s", path);
+    } else if (h.frames == 0) {
+        LOG_ERROR(LOG_INPUT, "Movie vazio: %s", path);
+        ok = 0;
+    } else if (h.mapper != movie->header.mapper || h.prg_banks != movie->header.prg_banks ||
+               h.rom_hash != movie->header.rom_hash) {
+        LOG_ERROR(LOG_INPUT, "Movie %s foi gravado com outra ROM", path);
+        ok = 0;
+    } else {
+        movie->frames = malloc(h.frames * sizeof(movie_frame_t));
+        ok = movie->frames && fread(movie->frames, sizeof(movie_frame_t), h.frames, f) == h.frames;
+        if (!ok) LOG_ERROR(LOG_INPUT, "Movie truncado: %s", path);
+    }
+    fclose(f);
+
+    if (!ok) {
+        if (movie) movie_free(movie);
+        return NULL;
+    }
+    movie->count = movie->capacity = (int)h.frames;
+    LOG_INFO(LOG_INPUT, "Movie %s: %d frames", path, movie->count);
+    return movie;
+}
+
+// ======================
+// Por frame
+// ======================
+void movie_before_frame(nes_movie_t *movie, nes_cpu_t *cpu) {
+    if (!movie) return;
+    nes_memory_t *mem = cpu->memory;
+    movie->current = mem->ppu->frame - movie->start_frame;
+
+    if (!movie->recording && movie->current >= 0 && !movie_finished(movie)) {
+        for (int port = 0; port < INPUT_PORTS; port++) {
+            input_set(mem->input, port, movie->frames[movie->current].buttons[port]);
+        }
+    }
+}
+
+void movie_after_frame(nes_movie_t *movie, nes_cpu_t *cpu) {
+    if (!movie || movie->current < 0) return;   // antes do início (rewind)
+    nes_memory_t *mem = cpu->memory;
+    int i = movie->current;
+
+    if (movie->recording) {
+        if (i >= movie->capacity) {
+            int capacity = movie->capacity ? movie->capacity * 2 : 4096;
+            movie_frame_t *frames = realloc(movie->frames, (size_t)capacity * sizeof(movie_frame_t));
+            if (!frames) return;
+            movie->frames = frames;
+            movie->capacity = capacity;
+        }
+        movie_frame_t *fr = &movie->frames[i];
+        memset(fr, 0, sizeof(*fr));
+        fr->hash = frame_hash(mem);
+        memcpy(fr->buttons, mem->input->buttons, INPUT_PORTS);
+        movie->count = i + 1;   // depois de um rewind, o resto é regravado
+        return;
+    }
+
+    if (i >= movie->count) return;
+    if (movie->frames[i].hash != frame_hash(mem)) {
+        if (movie->first_mismatch < 0) {
+            movie->first_mismatch = i;
+            LOG_ERROR(LOG_INPUT, "Movie diverge no frame %d", i);
+        }
+        movie->mismatches++;
+    }
+}
+
+int movie_finished(nes_movie_t *movie) {
+    if (!movie || movie->recording) return 0;
+    return movie->current >= movie->count;
+}
+
+// ======================
+// Fechamento
+// ======================
+int movie_close(nes_movie_t *movie) {
+    if (!movie) return 1;
+    int ok = 1;
+
+    if (movie->recording) {
+        FILE *f = fopen(movie->path, "wb");
+        movie->header.frames = (uint32_t)movie->count;
+        ok = f && fwrite(&movie->header, sizeof(movie->header), 1, f) == 1 &&
+             fwrite(movie->frames, sizeof(movie_frame_t), (size_t)movie->count, f) == (size_t)movie->count;
+        if (f) fclose(f);
+        if (ok) LOG_INFO(LOG_INPUT, "Movie gravado: %s (%d frames)", movie->path, movie->count);
+        else LOG_ERROR(LOG_INPUT, "Erro ao gravar movie %s", movie->path);
+    }
+
+    movie_free(movie);
+    return ok;
+}
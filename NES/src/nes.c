@@ -0,0 +1,23 @@
+#include "nes.h"
+#include "memory.h"
+
+void nes_run_frame(nes_cpu_t *cpu, nes_ppu_t *ppu, int present) {
+    nes_apu_t *apu = cpu->memory->apu;
+    int frame = ppu->frame;
+
+    while (ppu->frame == frame) {
+        // CPU roda solta até o próximo evento da PPU ou IRQ da APU; no
+        // meio do caminho PPU e APU só andam nos acessos aos registradores
+        uint64_t event = ppu_next_event(ppu);
+        uint64_t apu_event = apu_next_event(apu);
+        if (apu_event < event) event = apu_event;
+        int budget = event > cpu->cycles ? (int)(event - cpu->cycles) : 1;
+
+        cpu_run(cpu, budget);
+        ppu_catch_up(ppu, cpu, cpu->cycles);
+        if (cpu->cycles >= apu_next_event(apu)) apu_catch_up(apu, cpu->cycles);
+    }
+
+    apu_end_frame(apu, cpu->cycles);
+    if (present) ppu_render(ppu);
+}
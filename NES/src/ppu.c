@@ -1,29 +1,55 @@
-#include <SDL2/SDL.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include "ppu.h"
 #include "cpu.h"
+#include "video.h"
+#include "ppu_simd.h"
+#include "mapper.h"
 
-// Framebuffer global
-static uint32_t framebuffer[NES_SCREEN_HEIGHT][NES_SCREEN_WIDTH];
-
-// Paleta oficial NES (64 cores)
+// Paleta oficial NES (64 cores, ARGB8888)
 static const uint32_t nes_palette[64] = {
-    0x666666, 0x882A00, 0xA71214, 0xA4003C, 0x7C0074, 0x380092, 0x0010A4, 0x00206F,
-    0x003400, 0x005000, 0x004C00, 0x003A00, 0x000000, 0x000000, 0x000000, 0x000000,
-    0xADADAD, 0xD45528, 0xFB3C2E, 0xFF283C, 0xF5008F, 0x8D17B7, 0x1F32D2, 0x0054C6,
-    0x006C28, 0x009400, 0x00A000, 0x008C00, 0x313131, 0x000000, 0x000000, 0x000000,
-    0xFFFFFF, 0xFFA77A, 0xFF8277, 0xFF7787, 0xFF51C1, 0xD36CF0, 0x6092FF, 0x3EBAFF,
-    0x48D374, 0x25E02C, 0x1EDF1D, 0x2AD218, 0x4E4E4E, 0x000000, 0x000000, 0x000000,
-    0xFFFFFF, 0xFFCFBE, 0xFFBDB9, 0xFFBAC0, 0xFFA5DB, 0xE7B2F7, 0xB3C4FF, 0x9AD1FF,
-    0xA2E0BF, 0x93E89C, 0x90E891, 0x9EE88D, 0xB2B2B2, 0x000000, 0x000000, 0x000000
+    0xFF666666, 0xFF002A88, 0xFF1412A7, 0xFF3C00A4, 0xFF74007C, 0xFF920038, 0xFFA41000, 0xFF6F2000,
+    0xFF003400, 0xFF005000, 0xFF004C00, 0xFF003A00, 0xFF000000, 0xFF000000, 0xFF000000, 0xFF000000,
+    0xFFADADAD, 0xFF2855D4, 0xFF2E3CFB, 0xFF3C28FF, 0xFF8F00F5, 0xFFB7178D, 0xFFD2321F, 0xFFC65400,
+    0xFF286C00, 0xFF009400, 0xFF00A000, 0xFF008C00, 0xFF313131, 0xFF000000, 0xFF000000, 0xFF000000,
+    0xFFFFFFFF, 0xFF7AA7FF, 0xFF7782FF, 0xFF8777FF, 0xFFC151FF, 0xFFF06CD3, 0xFFFF9260, 0xFFFFBA3E,
+    0xFF74D348, 0xFF2CE025, 0xFF1DDF1E, 0xFF18D22A, 0xFF4E4E4E, 0xFF000000, 0xFF000000, 0xFF000000,
+    0xFFFFFFFF, 0xFFBECFFF, 0xFFB9BDFF, 0xFFC0BAFF, 0xFFDBA5FF, 0xFFF7B2E7, 0xFFFFC4B3, 0xFFFFD19A,
+    0xFFBFE0A2, 0xFF9CE893, 0xFF91E890, 0xFF8DE89E, 0xFFB2B2B2, 0xFF000000, 0xFF000000, 0xFF000000
 };
 
-// Variáveis SDL globais
-static SDL_Window   *window   = NULL;
-static SDL_Renderer *renderer = NULL;
-static SDL_Texture  *texture  = NULL;
+// ======================
+// Paleta ARGB resolvida
+// ======================
+
+// Cor final de uma entrada da palette RAM considerando PPUMASK:
+// bit 0 = tons de cinza, bits 5-7 = ênfase em vermelho/verde/azul
+static uint32_t resolve_color(uint8_t entry, uint8_t mask) {
+    uint32_t color = nes_palette[entry & ((mask & 0x01) ? 0x30 : 0x3F)];
+    if (!(mask & 0xE0)) return color;
+
+    // Cada bit de ênfase atenua os outros dois canais (~75%)
+    int r = (color >> 16) & 0xFF, g = (color >> 8) & 0xFF, b = color & 0xFF;
+    if (mask & 0x20) { g = g * 3 / 4; b = b * 3 / 4; }
+    if (mask & 0x40) { r = r * 3 / 4; b = b * 3 / 4; }
+    if (mask & 0x80) { r = r * 3 / 4; g = g * 3 / 4; }
+    return 0xFF000000 | (r << 16) | (g << 8) | b;
+}
+
+// Atualiza a entrada i do cache (e o espelho 0x10/14/18/1C ↔ 0x00/04/08/0C)
+static inline void palette_update(nes_ppu_t *ppu, int i) {
+    uint32_t color = resolve_color(ppu->palette[i], ppu->ppumask);
+    ppu->palette_argb[i] = color;
+    if ((i & 0x03) == 0) ppu->palette_argb[i ^ 0x10] = color;
+}
+
+static void palette_rebuild(nes_ppu_t *ppu) {
+    for (int i = 0; i < 16; i++) palette_update(ppu, i);
+    for (int i = 0x11; i < 32; i++) {
+        if (i & 0x03) palette_update(ppu, i);
+    }
+}
 
 // ======================
 // Inicialização e destruição
@@ -33,77 +59,162 @@ nes_ppu_t* ppu_init(nes_rom_t *rom) {
     if (!ppu) return NULL;
 
     ppu->rom = rom;
+    ppu_simd_init();
 
     // Inicializa arrays
     memset(ppu->vram, 0, sizeof(ppu->vram));
     memset(ppu->palette, 0, sizeof(ppu->palette));
     memset(ppu->oam, 0, sizeof(ppu->oam));
 
+    // CHR-ROM do cartucho ou CHR-RAM interna
+    if (rom->chr_rom && rom->chr_rom_bytes >= 0x2000) {
+        ppu->chr_mem = rom->chr_rom;
+        ppu->chr_size = (uint32_t)rom->chr_rom_bytes;
+        ppu->chr_writable = 0;
+    } else {
+        ppu->chr_mem = ppu->chr_ram;
+        ppu->chr_size = sizeof(ppu->chr_ram);
+        ppu->chr_writable = 1;
+    }
+
+    // Cache cobre a CHR inteira; tudo começa sujo
+    int tiles = ppu->chr_size / 16;
+    ppu->chr_decoded = malloc((size_t)tiles * sizeof(ppu->chr_decoded[0]));
+    ppu->chr_dirty = malloc(tiles);
+    if (!ppu->chr_decoded || !ppu->chr_dirty) {
+        ppu_free(ppu);
+        return NULL;
+    }
+    memset(ppu->chr_dirty, 1, tiles);
+
+    // Sem mapper: os primeiros 8 KB
+    for (int i = 0; i < 8; i++) ppu_set_chr_bank(ppu, i, i * 0x400);
+    ppu_set_mirroring(ppu, rom->mirroring ? PPU_MIRROR_VERTICAL : PPU_MIRROR_HORIZONTAL);
+
     // Inicializa registradores
-    ppu->ppu_addr = 0;
-    ppu->ppu_addr_latch = 0;
     ppu->ppuctrl = 0;
     ppu->ppumask = 0;
     ppu->ppustatus = 0;
-    ppu->ppuscroll_x = 0;
-    ppu->ppuscroll_y = 0;
-    ppu->ppuscroll_latch = 0;
+    ppu->oamaddr = 0;
+    ppu->v = 0;
+    ppu->t = 0;
+    ppu->x = 0;
+    ppu->w = 0;
+    palette_rebuild(ppu);
 
     // Inicializa temporização
     ppu->cycle = 0;
     ppu->scanline = 0;
     ppu->frame = 0;
 
-    // Inicializa SDL
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        printf("Erro ao inicializar SDL: %s\n", SDL_GetError());
-        free(ppu);
-        return NULL;
-    }
+    return ppu;
+}
 
-    window = SDL_CreateWindow("NES Emulator - PPU",
-        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-        NES_SCREEN_WIDTH * 3, NES_SCREEN_HEIGHT * 3,
-        0);
+void ppu_free(nes_ppu_t *ppu) {
+    if (!ppu) return;
+    free(ppu->chr_decoded);
+    free(ppu->chr_dirty);
+    free(ppu);
+}
 
-    if (!window) {
-        printf("Erro ao criar janela: %s\n", SDL_GetError());
-        free(ppu);
-        return NULL;
+void ppu_set_mirroring(nes_ppu_t *ppu, int mode) {
+    static const uint8_t banks[4][4] = {
+        { 0, 0, 1, 1 }, // horizontal
+        { 0, 1, 0, 1 }, // vertical
+        { 0, 0, 0, 0 }, // single-screen baixo
+        { 1, 1, 1, 1 }, // single-screen alto
+    };
+    for (int i = 0; i < 4; i++) {
+        ppu->nametable[i] = ppu->vram + banks[mode & 3][i] * 0x400;
     }
+}
 
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-    if (!renderer) {
-        printf("Erro ao criar renderer: %s\n", SDL_GetError());
-        SDL_DestroyWindow(window);
-        free(ppu);
-        return NULL;
+// ======================
+// Cache de tiles (CHR decodificado)
+// ======================
+
+// Expande os 2 bitplanes de um tile (16 bytes) em 8x8 índices de cor
+static inline void chr_decode_tile(const uint8_t *src, uint8_t dst[8][8]) {
+    ppu_decode_tile(src, &dst[0][0]);
+}
+
+// Tile físico (índice em chr_mem / 16) visto no tile 0-511 da PPU
+static inline int chr_phys_tile(nes_ppu_t *ppu, int tile) {
+    return ppu->chr_bank_tile[tile >> 6] + (tile & 63);
+}
+
+void ppu_chr_invalidate(nes_ppu_t *ppu, uint16_t addr, uint16_t len) {
+    if (len == 0) return;
+    int first = (addr & 0x1FFF) >> 4;
+    int last = ((addr & 0x1FFF) + len - 1) >> 4;
+    if (last > 511) last = 511;
+    for (int tile = first; tile <= last; tile++) {
+        ppu->chr_dirty[chr_phys_tile(ppu, tile)] = 1;
     }
+}
 
-    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
-        SDL_TEXTUREACCESS_STREAMING,
-        NES_SCREEN_WIDTH, NES_SCREEN_HEIGHT);
+void ppu_set_chr_bank(nes_ppu_t *ppu, int slot, uint32_t offset) {
+    offset = (offset % ppu->chr_size) & ~0x3FFu;
+    ppu->chr_bank[slot & 7] = ppu->chr_mem + offset;
+    ppu->chr_bank_tile[slot & 7] = offset >> 4;
+}
 
-    if (!texture) {
-        printf("Erro ao criar texture: %s\n", SDL_GetError());
-        SDL_DestroyRenderer(renderer);
-        SDL_DestroyWindow(window);
-        free(ppu);
-        return NULL;
+// Linha decodificada de um tile (tile = 0-511, endereço / 16)
+static inline const uint8_t* chr_tile_row(nes_ppu_t *ppu, int tile, int row) {
+    int phys = chr_phys_tile(ppu, tile);
+    if (ppu->chr_dirty[phys]) {
+        chr_decode_tile(&ppu->chr_mem[phys * 16], ppu->chr_decoded[phys]);
+        ppu->chr_dirty[phys] = 0;
     }
+    return ppu->chr_decoded[phys][row];
+}
 
-    return ppu;
+// Entrega o frame pronto para o backend de vídeo (se houver)
+void ppu_present(nes_ppu_t *ppu) {
+    video_present(ppu->video, &ppu->framebuffer[0][0]);
 }
 
-void ppu_free(nes_ppu_t *ppu) {
-    if (!ppu) return;
-    
-    if (texture) SDL_DestroyTexture(texture);
-    if (renderer) SDL_DestroyRenderer(renderer);
-    if (window) SDL_DestroyWindow(window);
-    SDL_Quit();
-    
-    free(ppu);
+// ======================
+// Barramento interno da PPU ($0000-$3FFF)
+// ======================
+static inline uint8_t ppu_bus_read(nes_ppu_t *ppu, uint16_t addr) {
+    addr &= 0x3FFF;
+    if (addr < 0x2000) {
+        // Pattern tables (CHR, pelos bancos do mapper)
+        if (ppu->mapper && ppu->mapper->ppu_read) return ppu->mapper->ppu_read(ppu->mapper, addr);
+        return ppu->chr_bank[(addr >> 10) & 7][addr & 0x3FF];
+    } else if (addr < 0x3F00) {
+        // Nametables ($3000-$3EFF espelha $2000-$2EFF)
+        return ppu->nametable[(addr >> 10) & 3][addr & 0x3FF];
+    } else {
+        // Palette (espelhamento 0x3F10/14/18/1C → 0x3F00/04/08/0C)
+        uint16_t pal_addr = addr & 0x1F;
+        if ((pal_addr % 4) == 0) pal_addr &= 0x0F;
+        return ppu->palette[pal_addr];
+    }
+}
+
+static inline void ppu_bus_write(nes_ppu_t *ppu, uint16_t addr, uint8_t value) {
+    addr &= 0x3FFF;
+    if (addr < 0x2000) {
+        // CHR-ROM é read-only; CHR-RAM aceita escrita
+        if (ppu->mapper && ppu->mapper->ppu_write) {
+            ppu->mapper->ppu_write(ppu->mapper, addr, value);
+            return;
+        }
+        uint8_t *cell = &ppu->chr_bank[(addr >> 10) & 7][addr & 0x3FF];
+        if (ppu->chr_writable && *cell != value) {
+            *cell = value;
+            ppu->chr_dirty[chr_phys_tile(ppu, addr >> 4)] = 1;
+        }
+    } else if (addr < 0x3F00) {
+        ppu->nametable[(addr >> 10) & 3][addr & 0x3FF] = value;
+    } else {
+        uint16_t pal_addr = addr & 0x1F;
+        if ((pal_addr % 4) == 0) pal_addr &= 0x0F;
+        ppu->palette[pal_addr] = value;
+        palette_update(ppu, pal_addr);
+    }
 }
 
 // ======================
@@ -114,29 +225,29 @@ uint8_t ppu_read(nes_ppu_t *ppu, uint16_t addr) {
 
     switch (addr) {
         case 0x2002: { // PPUSTATUS
-            uint8_t status = ppu->ppustatus;
+            uint8_t status = ppu->ppustatus & 0xE0;
             // ao ler, latch volta a 0
-            ppu->ppu_addr_latch = 0;
+            ppu->w = 0;
             // VBlank flag (bit 7) é zerado ao ler
             ppu->ppustatus &= ~0x80;
             return status;
         }
+        case 0x2004: // OAMDATA
+            return ppu->oam[ppu->oamaddr];
+
         case 0x2007: { // PPUDATA
-            uint8_t value = 0;
-            if (ppu->ppu_addr < 0x2000) {
-                // CHR-ROM
-                value = ppu->rom->chr_rom[ppu->ppu_addr];
-            } else if (ppu->ppu_addr >= 0x2000 && ppu->ppu_addr < 0x3F00) {
-                // VRAM
-                value = ppu->vram[(ppu->ppu_addr - 0x2000) % 0x800];
-            } else if (ppu->ppu_addr >= 0x3F00 && ppu->ppu_addr < 0x3F20) {
-                // Palette
-                uint16_t pal_addr = (ppu->ppu_addr - 0x3F00) % 32;
-                // Espelhamento 0x3F10/14/18/1C → 0x3F00/04/08/0C
-                if ((pal_addr % 4) == 0) pal_addr &= 0x0F;
-                value = ppu->palette[pal_addr];
+            uint16_t vaddr = ppu->v & 0x3FFF;
+            uint8_t value;
+            if (vaddr < 0x3F00) {
+                // Leitura atrasada: devolve o buffer e carrega o novo valor
+                value = ppu->ppudata_buffer;
+                ppu->ppudata_buffer = ppu_bus_read(ppu, vaddr);
+            } else {
+                // Palette responde direto; o buffer pega a nametable "embaixo"
+                value = ppu_bus_read(ppu, vaddr);
+                ppu->ppudata_buffer = ppu_bus_read(ppu, vaddr - 0x1000);
             }
-            ppu->ppu_addr++;
+            ppu->v = (ppu->v + ((ppu->ppuctrl & 0x04) ? 32 : 1)) & 0x7FFF;
             return value;
         }
     }
@@ -149,50 +260,59 @@ void ppu_write(nes_ppu_t *ppu, uint16_t addr, uint8_t value) {
 
     switch (addr) {
         case 0x2000: // PPUCTRL
+            // Ligar NMI durante o VBlank dispara NMI na hora
+            if (!(ppu->ppuctrl & 0x80) && (value & 0x80) && (ppu->ppustatus & 0x80)) {
+                ppu->nmi_pending = 1;
+            }
             ppu->ppuctrl = value;
+            ppu->t = (ppu->t & 0xF3FF) | ((value & 0x03) << 10); // nametable base
             break;
 
-        case 0x2001: // PPUMASK
+        case 0x2001: { // PPUMASK
+            // Tons de cinza/ênfase mudam todas as cores resolvidas
+            int recolor = (ppu->ppumask ^ value) & 0xE1;
             ppu->ppumask = value;
+            if (recolor) palette_rebuild(ppu);
+            break;
+        }
+
+        case 0x2003: // OAMADDR
+            ppu->oamaddr = value;
+            break;
+
+        case 0x2004: // OAMDATA
+            ppu->oam[ppu->oamaddr++] = value;
             break;
 
         case 0x2005: // PPUSCROLL
-            if (ppu->ppuscroll_latch == 0) {
-                ppu->ppuscroll_x = value;
-                ppu->ppuscroll_latch = 1;
+            if (ppu->w == 0) {
+                ppu->t = (ppu->t & ~0x001F) | (value >> 3); // coarse X
+                ppu->x = value & 0x07;                      // fine X
+                ppu->w = 1;
             } else {
-                ppu->ppuscroll_y = value;
-                ppu->ppuscroll_latch = 0;
+                ppu->t = (ppu->t & ~0x73E0)
+                       | ((value & 0x07) << 12)             // fine Y
+                       | ((value & 0xF8) << 2);             // coarse Y
+                ppu->w = 0;
             }
             break;
 
         case 0x2006: // PPUADDR
-            if (ppu->ppu_addr_latch == 0) {
-                // primeiro write = high byte
-                ppu->ppu_addr = (value & 0x3F) << 8; // só 14 bits válidos
-                ppu->ppu_addr_latch = 1;
+            if (ppu->w == 0) {
+                // primeiro write = high byte (só 14 bits válidos)
+                ppu->t = (ppu->t & 0x00FF) | ((value & 0x3F) << 8);
+                ppu->w = 1;
             } else {
-                // segundo write = low byte
-                ppu->ppu_addr |= value;
-                ppu->ppu_addr &= 0x3FFF; // garante limite 14 bits
-                ppu->ppu_addr_latch = 0;
+                // segundo write = low byte, copia t → v
+                ppu->t = (ppu->t & 0xFF00) | value;
+                ppu->v = ppu->t;
+                ppu->w = 0;
             }
             break;
-        
-        printf("[DEBUG] Write em VRAM: addr=0x%04X valor=0x%02X\n", ppu->ppu_addr, value);
+
         case 0x2007: // PPUDATA
-            if (ppu->ppu_addr < 0x2000) {
-                // CHR-ROM é read-only
-            } else if (ppu->ppu_addr >= 0x2000 && ppu->ppu_addr < 0x3F00) {
-                // VRAM
-                ppu->vram[(ppu->ppu_addr - 0x2000) % 0x800] = value;
-            } else if (ppu->ppu_addr >= 0x3F00 && ppu->ppu_addr < 0x3F20) {
-                // Palette
-                uint16_t pal_addr = (ppu->ppu_addr - 0x3F00) % 32;
-                if ((pal_addr % 4) == 0) pal_addr &= 0x0F;
-                ppu->palette[pal_addr] = value;
-            }
-            ppu->ppu_addr++;
+            ppu_bus_write(ppu, ppu->v, value);
+            ppu->v = (ppu->v + ((ppu->ppuctrl & 0x04) ? 32 : 1)) & 0x7FFF;
             break;
 
         default: break;
@@ -202,190 +322,387 @@ void ppu_write(nes_ppu_t *ppu, uint16_t addr, uint8_t value) {
 // ======================
 // Renderização
 // ======================
+
+// Fim de frame: os pixels já foram gerados scanline a scanline pelo
+// ppu_step, aqui só entregamos o frame pronto.
 void ppu_render(nes_ppu_t *ppu) {
-    // === VERIFICAÇÕES DE SEGURANÇA ===
-    if (!ppu) {
-        printf("ERRO: ppu é NULL\n");
-        return;
-    }
-    
-    if (!ppu->rom) {
-        printf("ERRO: ppu->rom é NULL\n");
-        return;
-    }
-    
-    if (!ppu->rom->chr_rom) {
-        printf("ERRO: CHR-ROM não carregada\n");
-        return;
-    }
-    
-    if (!texture || !renderer) {
-        printf("ERRO: SDL não inicializado (texture=%p, renderer=%p)\n", (void*)texture, (void*)renderer);
-        return;
-    }
-    
-    printf("[DEBUG] ppu_render iniciado - CHR-ROM: %zu bytes\n", ppu->rom->chr_rom_bytes);
-    
-    // === INICIALIZAÇÃO ===
+    if (!ppu) return;
+    ppu_present(ppu);
+}
+
+void ppu_render_chr_rom(nes_ppu_t *ppu, uint8_t *chr_rom) {
     int tileSize = 8;
-    uint8_t *chr_rom = ppu->rom->chr_rom;
-    uint8_t *nametable = ppu->vram; // simplificação: mapeie VRAM direto
-
-    // Limpa o framebuffer com cor de fundo
-    uint32_t bg_color = nes_palette[ppu->palette[0] & 0x3F];
-    for (int y = 0; y < NES_SCREEN_HEIGHT; y++) {
-        for (int x = 0; x < NES_SCREEN_WIDTH; x++) {
-            framebuffer[y][x] = bg_color;
-        }
-    }
+    int tilesPerRow = 16;
+    int numTiles = 256;
+    uint8_t decoded[8][8];
+
+    for (int t = 0; t < numTiles; t++) {
+        int tx = (t % tilesPerRow) * tileSize;
+        int ty = (t / tilesPerRow) * tileSize;
 
-    // === RENDERIZAÇÃO DOS TILES ===
-    // Percorre 30 linhas × 32 colunas de tiles
-    for (int ty = 0; ty < 30; ty++) {
-        for (int tx = 0; tx < 32; tx++) {
-            int tileIndex = nametable[ty * 32 + tx];
-            uint16_t base = tileIndex * 16; // posição na CHR-ROM
-
-            // === PROTEÇÃO CONTRA OVERFLOW ===
-            if (base + 15 >= ppu->rom->chr_rom_bytes) {
-                printf("AVISO: tile %d (base=0x%04X) fora do CHR-ROM (%zu bytes)\n", 
-                       tileIndex, base, ppu->rom->chr_rom_bytes);
-                continue; // pula este tile
+        // CHR da própria PPU vem do cache; outro buffer é decodificado na hora
+        if (chr_rom == ppu->chr_mem) {
+            for (int row = 0; row < 8; row++) {
+                memcpy(decoded[row], chr_tile_row(ppu, t, row), 8);
             }
+        } else {
+            chr_decode_tile(&chr_rom[t * 16], decoded);
+        }
+
+        for (int row = 0; row < 8; row++) {
+            for (int col = 0; col < 8; col++) {
+                uint8_t colorIndex = decoded[row][col];
 
-            // Calcula qual paleta usar (simplificado: usa paleta 0 do background)
-            int paletteIndex = 0; // paletas 0-3 para background
+                // Usa paleta real (para debug, a primeira do BG)
+                uint32_t color = ppu->palette_argb[colorIndex];
 
-            // === DESENHA TILE 8x8 ===
-            for (int row = 0; row < 8; row++) {
-                uint8_t plane1 = chr_rom[base + row];
-                uint8_t plane2 = chr_rom[base + row + 8];
-
-                for (int col = 0; col < 8; col++) {
-                    int bit = 7 - col;
-                    uint8_t low  = (plane1 >> bit) & 1;
-                    uint8_t high = (plane2 >> bit) & 1;
-                    uint8_t colorIndex = (high << 1) | low;
-
-                    // === BUSCA COR NA PALETA ===
-                    uint32_t color;
-                    if (colorIndex == 0) {
-                        // Cor 0 sempre usa a cor universal (0x3F00)
-                        color = nes_palette[ppu->palette[0] & 0x3F];
-                    } else {
-                        // Cores 1-3 usam a paleta específica
-                        int paletteAddr = paletteIndex * 4 + colorIndex;
-                        
-                        // Proteção contra overflow da paleta
-                        if (paletteAddr >= 32) {
-                            paletteAddr = paletteAddr % 32;
-                        }
-                        
-                        color = nes_palette[ppu->palette[paletteAddr] & 0x3F];
-                    }
-
-                    // === CALCULA PIXEL NO FRAMEBUFFER ===
-                    int px = tx * tileSize + col;
-                    int py = ty * tileSize + row;
-                    
-                    // Proteção contra overflow do framebuffer
-                    if (px >= 0 && px < NES_SCREEN_WIDTH && py >= 0 && py < NES_SCREEN_HEIGHT) {
-                        framebuffer[py][px] = color;
-                    }
+                int px = tx + col;
+                int py = ty + row;
+                if (px < NES_SCREEN_WIDTH && py < NES_SCREEN_HEIGHT) {
+                    ppu->framebuffer[py][px] = color;
                 }
             }
         }
     }
 
-    // === ATUALIZA TELA SDL ===
-    if (SDL_UpdateTexture(texture, NULL, framebuffer, NES_SCREEN_WIDTH * sizeof(uint32_t)) != 0) {
-        printf("ERRO SDL_UpdateTexture: %s\n", SDL_GetError());
-        return;
+    ppu_present(ppu);
+}
+
+// ======================
+// Scroll (incrementos do registrador v)
+// ======================
+static inline void increment_x(nes_ppu_t *ppu) {
+    if ((ppu->v & 0x001F) == 31) {
+        ppu->v &= ~0x001F;
+        ppu->v ^= 0x0400; // troca nametable horizontal
+    } else {
+        ppu->v++;
     }
-    
-    if (SDL_RenderClear(renderer) != 0) {
-        printf("ERRO SDL_RenderClear: %s\n", SDL_GetError());
+}
+
+static inline void increment_y(nes_ppu_t *ppu) {
+    if ((ppu->v & 0x7000) != 0x7000) {
+        ppu->v += 0x1000; // fine Y
         return;
     }
-    
-    if (SDL_RenderCopy(renderer, texture, NULL, NULL) != 0) {
-        printf("ERRO SDL_RenderCopy: %s\n", SDL_GetError());
-        return;
+    ppu->v &= ~0x7000;
+    int y = (ppu->v & 0x03E0) >> 5;
+    if (y == 29) {
+        y = 0;
+        ppu->v ^= 0x0800; // troca nametable vertical
+    } else if (y == 31) {
+        y = 0;
+    } else {
+        y++;
     }
-    
-    SDL_RenderPresent(renderer);
-    
-    printf("[DEBUG] ppu_render concluído com sucesso\n");
+    ppu->v = (ppu->v & ~0x03E0) | (y << 5);
 }
 
-void ppu_render_chr_rom(nes_ppu_t *ppu, uint8_t *chr_rom) {
-    int tileSize = 8;
-    int tilesPerRow = 16;
-    int numTiles = 256;
-
-    for (int t = 0; t < numTiles; t++) {
-        int tx = (t % tilesPerRow) * tileSize;
-        int ty = (t / tilesPerRow) * tileSize;
+static inline void transfer_x(nes_ppu_t *ppu) {
+    ppu->v = (ppu->v & ~0x041F) | (ppu->t & 0x041F);
+}
 
-        uint16_t base = t * 16;
+static inline void transfer_y(nes_ppu_t *ppu) {
+    ppu->v = (ppu->v & ~0x7BE0) | (ppu->t & 0x7BE0);
+}
 
-        for (int row = 0; row < 8; row++) {
-            uint8_t plane1 = chr_rom[base + row];
-            uint8_t plane2 = chr_rom[base + row + 8];
+// ======================
+// Background: fetches para a fila da linha
+// ======================
 
+// Um fetch de 8 dots: nametable, atributo e a linha do tile (já
+// decodificada no cache) vão para o slot "slot" da fila
+static inline void bg_fetch(nes_ppu_t *ppu, int step, int slot) {
+    uint16_t v = ppu->v;
+    switch (step) {
+        case 0:
+            ppu->bg_next_tile = ppu_bus_read(ppu, 0x2000 | (v & 0x0FFF));
+            break;
+        case 2: {
+            uint8_t attr = ppu_bus_read(ppu, 0x23C0 | (v & 0x0C00) | ((v >> 4) & 0x38) | ((v >> 2) & 0x07));
+            if (v & 0x0040) attr >>= 4; // metade de baixo do bloco 32x32
+            if (v & 0x0002) attr >>= 2; // metade da direita
+            ppu->bg_next_attr = attr & 0x03;
+            break;
+        }
+        case 6: {
+            // No hardware: planos baixo (dot 5) e alto (dot 7)
+            int tile = ((ppu->ppuctrl & 0x10) << 4) | ppu->bg_next_tile;
+            const uint8_t *row = chr_tile_row(ppu, tile, (v >> 12) & 7);
+            uint8_t pal = ppu->bg_next_attr << 2;
+            uint8_t *dst = &ppu->bg_line[slot * 8];
             for (int col = 0; col < 8; col++) {
-                int bit = 7 - col;
-                uint8_t low = (plane1 >> bit) & 1;
-                uint8_t high = (plane2 >> bit) & 1;
-                uint8_t colorIndex = (high << 1) | low;
-
-                // Usa paleta real em vez de cores fixas
-                uint32_t color;
-                if (colorIndex == 0) {
-                    color = nes_palette[ppu->palette[0] & 0x3F];
-                } else {
-                    // Para debug, usa primeira paleta
-                    color = nes_palette[ppu->palette[colorIndex] & 0x3F];
-                }
+                dst[col] = row[col] ? (pal | row[col]) : 0;
+            }
+            break;
+        }
+        case 7:
+            increment_x(ppu);
+            break;
+    }
+}
 
-                int px = tx + col;
-                int py = ty + row;
-                if (px < NES_SCREEN_WIDTH && py < NES_SCREEN_HEIGHT) {
-                    framebuffer[py][px] = color;
-                }
+// ======================
+// Sprites: avaliação (secondary OAM) e montagem da linha
+// ======================
+static void sprite_evaluate(nes_ppu_t *ppu, int line) {
+    int height = (ppu->ppuctrl & 0x20) ? 16 : 8;
+    int found_zero = 0;
+
+    ppu->sprite_count = 0;
+    memset(ppu->secondary_oam, 0xFF, sizeof(ppu->secondary_oam));
+    memset(ppu->sprite_line, 0, sizeof(ppu->sprite_line));
+
+    for (int i = 0; i < 64; i++) {
+        int row = line - ppu->oam[i * 4];
+        if (row < 0 || row >= height) continue;
+
+        if (ppu->sprite_count == 8) {
+            ppu->ppustatus |= 0x20; // sprite overflow
+            break;
+        }
+        memcpy(&ppu->secondary_oam[ppu->sprite_count * 4], &ppu->oam[i * 4], 4);
+        if (i == 0) found_zero = 1;
+        ppu->sprite_count++;
+    }
+
+    // Fetch dos padrões: o sprite de menor índice tem prioridade,
+    // então só escrevemos onde ainda não há pixel opaco
+    for (int s = 0; s < ppu->sprite_count; s++) {
+        uint8_t *spr = &ppu->secondary_oam[s * 4];
+        uint8_t tile = spr[1];
+        uint8_t attr = spr[2];
+        int row = line - spr[0];
+        if (attr & 0x80) row = height - 1 - row; // flip vertical
+
+        int index;
+        if (height == 16) {
+            index = ((tile & 1) << 8) | (tile & 0xFE);
+            if (row >= 8) {
+                index++;
+                row -= 8;
             }
+        } else {
+            index = ((ppu->ppuctrl & 0x08) << 5) | tile;
+        }
+        const uint8_t *pixels = chr_tile_row(ppu, index, row);
+
+        uint8_t flags = 0x10 | ((attr & 0x03) << 2);
+        if (attr & 0x20) flags |= 0x20;
+        if (s == 0 && found_zero) flags |= 0x40;
+
+        for (int col = 0; col < 8; col++) {
+            int px = spr[3] + col;
+            if (px >= NES_SCREEN_WIDTH) break;
+            uint8_t colorIndex = pixels[(attr & 0x40) ? 7 - col : col]; // flip horizontal
+            if (colorIndex == 0 || (ppu->sprite_line[px] & 0x03)) continue;
+            ppu->sprite_line[px] = flags | colorIndex;
         }
     }
+}
+
+// ======================
+// Composição de 8 pixels (BG + sprite)
+// ======================
+static const uint8_t no_pixels[8];
+
+static inline void render_span(nes_ppu_t *ppu, int x0) {
+    uint8_t mask = ppu->ppumask;
+    uint32_t *dst = &ppu->framebuffer[ppu->scanline][x0];
+
+    if (!(mask & 0x18)) {
+        // Renderização desligada: mostra a cor de fundo
+        for (int i = 0; i < 8; i++) dst[i] = ppu->palette_argb[0];
+        return;
+    }
+
+    // Os 8 pixels da esquerda podem estar recortados (PPUMASK bits 1/2)
+    const uint8_t *bg = ((mask & 0x08) && (x0 >= 8 || (mask & 0x02))) ? &ppu->bg_line[x0 + ppu->x] : no_pixels;
+    const uint8_t *sp = ((mask & 0x10) && (x0 >= 8 || (mask & 0x04))) ? &ppu->sprite_line[x0] : no_pixels;
 
-    SDL_UpdateTexture(texture, NULL, framebuffer, NES_SCREEN_WIDTH * sizeof(uint32_t));
-    SDL_RenderClear(renderer);
-    SDL_RenderCopy(renderer, texture, NULL, NULL);
-    SDL_RenderPresent(renderer);
+    int hit = ppu_compose_span8(bg, sp, ppu->palette_argb, dst);
+    if (x0 == NES_SCREEN_WIDTH - 8) hit &= 0x7F; // sem colisão no pixel 255
+    if (hit) ppu->ppustatus |= 0x40;             // sprite 0 hit
+}
+
+// Dot em que a linha de endereço A12 sobe numa scanline renderizada,
+// pelo padrão fixo de fetches, ou -1 se não sobe:
+// - sprites em $1000 → fetch de sprites (dot 260);
+// - BG em $1000 e sprites em $0000 → tiles da próxima linha (dot 324);
+// - as duas em $0000 → A12 nunca sobe, o mapper não recebe clock.
+// Sprites 8x16 ignoram o bit 3 (a tabela vem do bit 0 do tile), mas os
+// slots vazios buscam o tile $FF, que fica em $1000: tratamos como
+// sprites em $1000. Isso só erra em linhas com 8 sprites, todos de tile
+// par. Com as duas tabelas em $1000 a linha fica alta quase o tempo
+// todo; fica em 260 (aproximação).
+static inline int ppu_a12_dot(nes_ppu_t *ppu) {
+    if ((ppu->ppuctrl & 0x08) || (ppu->ppuctrl & 0x20)) return 260;
+    if (ppu->ppuctrl & 0x10) return 324;
+    return -1;
 }
 
 // ======================
-// Simulação de ciclos do PPU
+// Simulação de ciclos do PPU (1 dot por chamada)
 // ======================
-void ppu_step(nes_ppu_t *ppu, nes_cpu_t *cpu) {
-    ppu->cycle++;
+static inline void ppu_dot(nes_ppu_t *ppu, nes_cpu_t *cpu) {
+    if (ppu->nmi_pending) {
+        ppu->nmi_pending = 0;
+        cpu->nmi_pending = 1;
+    }
 
-    if (ppu->cycle >= 341) {
-        ppu->cycle = 0;
-        ppu->scanline++;
+    int line = ppu->scanline;
+    int dot = ppu->cycle;
+    int rendering = (ppu->ppumask & 0x18) != 0;
+
+    if (line < NES_SCREEN_HEIGHT || line == PPU_PRERENDER_LINE) {
+        if (line == PPU_PRERENDER_LINE && dot == 1) {
+            // fim do VBlank: limpa VBlank, sprite 0 hit e overflow
+            ppu->ppustatus &= ~0xE0;
+        }
+
+        if (rendering) {
+            // Tiles 2-33 da linha atual nos dots 1-256; tiles 0-1 da próxima em 321-336
+            if (dot >= 1 && dot <= 256) {
+                bg_fetch(ppu, (dot - 1) & 7, ((dot - 1) >> 3) + 2);
+            } else if (dot >= 321 && dot <= 336) {
+                bg_fetch(ppu, (dot - 1) & 7, (dot - 321) >> 3);
+            }
+            if (dot == 256) increment_y(ppu);
+            if (dot == 257) transfer_x(ppu);
+            if (line == PPU_PRERENDER_LINE && dot >= 280 && dot <= 304) {
+                transfer_y(ppu);
+            }
+        }
+
+        // Pixels saem em blocos de 8, no dot em que o último deles fica pronto
+        if (line < NES_SCREEN_HEIGHT) {
+            if (dot >= 8 && dot <= 256 && (dot & 7) == 0) render_span(ppu, dot - 8);
+        }
 
-        if (ppu->scanline == 241) {
-            // início de VBlank
-            ppu->ppustatus |= 0x80;
-            if (ppu->ppuctrl & 0x80) {
-                cpu_nmi(cpu);
+        // Sprites da próxima linha (a pre-render prepara a linha 0, que nunca tem sprites)
+        if (dot == 257) {
+            if (rendering && line < NES_SCREEN_HEIGHT - 1) {
+                sprite_evaluate(ppu, line);
+            } else {
+                ppu->sprite_count = 0;
+                memset(ppu->sprite_line, 0, sizeof(ppu->sprite_line));
             }
         }
 
-        if (ppu->scanline >= 262) {
+        // Contador de scanlines do mapper, no dot em que A12 sobe (com
+        // ppu_a12_dot = -1 não há clock)
+        if (ppu->mapper && ppu->mapper->scanline && rendering && dot == ppu_a12_dot(ppu)) {
+            ppu->mapper->scanline(ppu->mapper);
+            if (ppu->mapper->irq) cpu_set_irq(cpu, CPU_IRQ_MAPPER, ppu->mapper->irq(ppu->mapper));
+        }
+    }
+
+    if (line == PPU_VBLANK_SCANLINE && dot == 1) {
+        // início de VBlank
+        ppu->ppustatus |= 0x80;
+        if (ppu->ppuctrl & 0x80) {
+            cpu->nmi_pending = 1; // atendida pela CPU no próximo limite de instrução
+        }
+    }
+
+    // Avança o dot; frames ímpares pulam o último dot da pre-render
+    ppu->cycle++;
+    if (line == PPU_PRERENDER_LINE && dot == 339 && rendering && (ppu->frame & 1)) {
+        ppu->cycle = PPU_DOTS_PER_SCANLINE;
+    }
+
+    if (ppu->cycle >= PPU_DOTS_PER_SCANLINE) {
+        ppu->cycle = 0;
+        ppu->scanline++;
+
+        if (ppu->scanline >= PPU_SCANLINES) {
             // fim do frame
             ppu->scanline = 0;
             ppu->frame++;
-            ppu->ppustatus &= ~0x80;
         }
     }
 }
+
+void ppu_step(nes_ppu_t *ppu, nes_cpu_t *cpu) {
+    ppu_dot(ppu, cpu);
+}
+
+// ======================
+// Catch-up: a PPU só anda quando alguém precisa dela
+// ======================
+
+// Posição (em dots) dentro do frame
+#define PPU_POS(line, dot) ((line) * PPU_DOTS_PER_SCANLINE + (dot))
+#define PPU_FRAME_DOTS     (PPU_SCANLINES * PPU_DOTS_PER_SCANLINE)
+
+// Do dot 2 da linha 241 até o início da pre-render nada acontece
+#define PPU_IDLE_START PPU_POS(PPU_VBLANK_SCANLINE, 2)
+#define PPU_IDLE_END   PPU_POS(PPU_PRERENDER_LINE, 0)
+
+void ppu_catch_up(nes_ppu_t *ppu, nes_cpu_t *cpu, uint64_t cpu_cycle) {
+    if (cpu_cycle <= ppu->cpu_time) return;
+
+    uint64_t dots = (cpu_cycle - ppu->cpu_time) * 3;
+    ppu->cpu_time = cpu_cycle;
+
+    while (dots > 0) {
+        int pos = PPU_POS(ppu->scanline, ppu->cycle);
+
+        // VBlank ocioso: pula direto, sem simular dot a dot
+        if (pos >= PPU_IDLE_START && pos < PPU_IDLE_END) {
+            uint64_t idle = PPU_IDLE_END - pos;
+            if (idle > dots) idle = dots;
+            pos += (int)idle;
+            ppu->scanline = pos / PPU_DOTS_PER_SCANLINE;
+            ppu->cycle = pos % PPU_DOTS_PER_SCANLINE;
+            dots -= idle;
+            if (ppu->nmi_pending) {
+                ppu->nmi_pending = 0;
+                cpu->nmi_pending = 1;
+            }
+            continue;
+        }
+
+        ppu_dot(ppu, cpu);
+        dots--;
+    }
+}
+
+// Ciclos de CPU para a PPU processar o dot da posição target
+static uint64_t cycles_until(nes_ppu_t *ppu, int target) {
+    int pos = PPU_POS(ppu->scanline, ppu->cycle);
+    int dots = (target - pos + PPU_FRAME_DOTS) % PPU_FRAME_DOTS;
+    return ((uint64_t)dots + 3) / 3; // dots + 1 passos, arredondado para cima
+}
+
+// Ciclos até o clock de scanline que dispara o IRQ do mapper (só dentro
+// do frame atual; depois dele o fim de frame já é um evento mais cedo)
+static uint64_t cycles_until_mapper_irq(nes_ppu_t *ppu) {
+    nes_mapper_t *m = ppu->mapper;
+    if (!m || !m->irq_clocks || !(ppu->ppumask & 0x18)) return UINT64_MAX;
+
+    int clocks = m->irq_clocks(m);
+    if (clocks <= 0) return UINT64_MAX;
+
+    // Clocks nas linhas 0-239 e na pre-render, no dot de A12
+    int a12 = ppu_a12_dot(ppu);
+    if (a12 < 0) return UINT64_MAX;
+    int line = ppu->scanline + (ppu->cycle > a12 ? 1 : 0);
+    for (; line <= PPU_PRERENDER_LINE; line++) {
+        if (line >= NES_SCREEN_HEIGHT && line != PPU_PRERENDER_LINE) continue;
+        if (--clocks == 0) return cycles_until(ppu, PPU_POS(line, a12));
+    }
+    return UINT64_MAX;
+}
+
+uint64_t ppu_next_event(nes_ppu_t *ppu) {
+    // Início do VBlank (NMI), IRQ previsto do mapper ou fim do frame, o
+    // que vier antes. Sprite 0 hit e flags de $2002 não precisam de
+    // evento: a leitura faz catch-up.
+    uint64_t next = cycles_until(ppu, PPU_POS(PPU_VBLANK_SCANLINE, 1));
+    uint64_t frame_end = cycles_until(ppu, PPU_POS(PPU_PRERENDER_LINE, PPU_DOTS_PER_SCANLINE - 1));
+    uint64_t irq = cycles_until_mapper_irq(ppu);
+    if (frame_end < next) next = frame_end;
+    if (irq < next) next = irq;
+    return ppu->cpu_time + next;
+}
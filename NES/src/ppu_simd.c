@@ -0,0 +1,178 @@
+#include <stdlib.h>
+#include <string.h>
+#include "ppu_simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PPU_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// ======================
+// Escalar (qualquer CPU)
+// ======================
+
+// Espalha os 8 bits de um plano em 8 bytes 0/1 (bit 7 → byte 0)
+static inline uint64_t spread_plane(uint8_t plane) {
+    uint64_t m = (plane * 0x0101010101010101ull) & 0x0102040810204080ull;
+    return (((m + 0x7F7F7F7F7F7F7F7Full) | m) >> 7) & 0x0101010101010101ull;
+}
+
+static void decode_tile_scalar(const uint8_t *src, uint8_t dst[64]) {
+    for (int row = 0; row < 8; row++) {
+        uint64_t pixels = spread_plane(src[row]) | (spread_plane(src[row + 8]) << 1);
+        memcpy(&dst[row * 8], &pixels, 8);
+    }
+}
+
+static int compose_span8_scalar(const uint8_t *bg, const uint8_t *sp,
+                                const uint32_t *palette, uint32_t *dst) {
+    int hit = 0;
+    for (int i = 0; i < 8; i++) {
+        uint8_t pal_addr = bg[i];
+        if (sp[i] & 0x03) {
+            if (bg[i] && (sp[i] & 0x40)) hit |= 1 << i;
+            if (!bg[i] || !(sp[i] & 0x20)) pal_addr = sp[i] & 0x1F;
+        }
+        dst[i] = palette[pal_addr];
+    }
+    return hit;
+}
+
+#ifdef PPU_SIMD_X86
+// ======================
+// SSE2
+// ======================
+__attribute__((target("sse2")))
+static void decode_tile_sse2(const uint8_t *src, uint8_t dst[64]) {
+    const __m128i bits = _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, (char)128,
+                                      1, 2, 4, 8, 16, 32, 64, (char)128);
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i two = _mm_set1_epi8(2);
+
+    // 2 linhas por iteração
+    for (int row = 0; row < 8; row += 2) {
+        __m128i lo = _mm_set_epi64x((long long)(src[row + 1] * 0x0101010101010101ull),
+                                    (long long)(src[row] * 0x0101010101010101ull));
+        __m128i hi = _mm_set_epi64x((long long)(src[row + 9] * 0x0101010101010101ull),
+                                    (long long)(src[row + 8] * 0x0101010101010101ull));
+        lo = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(lo, bits), bits), one);
+        hi = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(hi, bits), bits), two);
+        _mm_storeu_si128((__m128i *)&dst[row * 8], _mm_or_si128(lo, hi));
+    }
+}
+
+// Composição BG/sprite de 8 pixels; devolve os endereços de paleta
+__attribute__((target("sse2")))
+static inline __m128i compose8_sse2(const uint8_t *bg, const uint8_t *sp, int *hit) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i b = _mm_loadl_epi64((const __m128i *)bg);
+    __m128i s = _mm_loadl_epi64((const __m128i *)sp);
+
+    __m128i sp_opaque = _mm_xor_si128(_mm_cmpeq_epi8(_mm_and_si128(s, _mm_set1_epi8(0x03)), zero),
+                                      _mm_set1_epi8(-1));
+    __m128i bg_opaque = _mm_xor_si128(_mm_cmpeq_epi8(b, zero), _mm_set1_epi8(-1));
+    __m128i behind = _mm_cmpeq_epi8(_mm_and_si128(s, _mm_set1_epi8(0x20)), _mm_set1_epi8(0x20));
+    __m128i zero_spr = _mm_cmpeq_epi8(_mm_and_si128(s, _mm_set1_epi8(0x40)), _mm_set1_epi8(0x40));
+
+    __m128i use_sp = _mm_andnot_si128(_mm_and_si128(behind, bg_opaque), sp_opaque);
+    __m128i idx = _mm_or_si128(_mm_and_si128(use_sp, _mm_and_si128(s, _mm_set1_epi8(0x1F))),
+                               _mm_andnot_si128(use_sp, b));
+
+    *hit = _mm_movemask_epi8(_mm_and_si128(_mm_and_si128(sp_opaque, bg_opaque), zero_spr)) & 0xFF;
+    return idx;
+}
+
+__attribute__((target("sse2")))
+static int compose_span8_sse2(const uint8_t *bg, const uint8_t *sp,
+                              const uint32_t *palette, uint32_t *dst) {
+    int hit;
+    uint8_t idx[16];
+    _mm_storeu_si128((__m128i *)idx, compose8_sse2(bg, sp, &hit));
+
+    // SSE2 não tem gather: 8 loads da tabela, 2 stores
+    __m128i c0 = _mm_set_epi32((int)palette[idx[3]], (int)palette[idx[2]], (int)palette[idx[1]], (int)palette[idx[0]]);
+    __m128i c1 = _mm_set_epi32((int)palette[idx[7]], (int)palette[idx[6]], (int)palette[idx[5]], (int)palette[idx[4]]);
+    _mm_storeu_si128((__m128i *)dst, c0);
+    _mm_storeu_si128((__m128i *)(dst + 4), c1);
+    return hit;
+}
+
+// ======================
+// AVX2
+// ======================
+__attribute__((target("avx2")))
+static void decode_tile_avx2(const uint8_t *src, uint8_t dst[64]) {
+    const __m256i bits = _mm256_set1_epi64x(0x0102040810204080ll);
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i two = _mm256_set1_epi8(2);
+
+    // 4 linhas por iteração
+    for (int row = 0; row < 8; row += 4) {
+        __m256i lo = _mm256_set_epi64x((long long)(src[row + 3] * 0x0101010101010101ull),
+                                       (long long)(src[row + 2] * 0x0101010101010101ull),
+                                       (long long)(src[row + 1] * 0x0101010101010101ull),
+                                       (long long)(src[row] * 0x0101010101010101ull));
+        __m256i hi = _mm256_set_epi64x((long long)(src[row + 11] * 0x0101010101010101ull),
+                                       (long long)(src[row + 10] * 0x0101010101010101ull),
+                                       (long long)(src[row + 9] * 0x0101010101010101ull),
+                                       (long long)(src[row + 8] * 0x0101010101010101ull));
+        lo = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(lo, bits), bits), one);
+        hi = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(hi, bits), bits), two);
+        _mm256_storeu_si256((__m256i *)&dst[row * 8], _mm256_or_si256(lo, hi));
+    }
+}
+
+__attribute__((target("avx2")))
+static int compose_span8_avx2(const uint8_t *bg, const uint8_t *sp,
+                              const uint32_t *palette, uint32_t *dst) {
+    int hit;
+    __m128i idx = compose8_sse2(bg, sp, &hit);
+
+    // 8 índices → 8 cores ARGB com um gather
+    __m256i colors = _mm256_i32gather_epi32((const int *)palette, _mm256_cvtepu8_epi32(idx), 4);
+    _mm256_storeu_si256((__m256i *)dst, colors);
+    return hit;
+}
+#endif
+
+// ======================
+// Seleção em tempo de execução
+// ======================
+void (*ppu_decode_tile)(const uint8_t *src, uint8_t dst[64]) = decode_tile_scalar;
+int (*ppu_compose_span8)(const uint8_t *bg, const uint8_t *sp,
+                         const uint32_t *palette, uint32_t *dst) = compose_span8_scalar;
+
+static const char *simd_name = "scalar";
+
+void ppu_simd_init(void) {
+    static int done = 0;
+    if (done) return;
+    done = 1;
+
+    const char *force = getenv("NES_SIMD");
+
+#ifdef PPU_SIMD_X86
+    __builtin_cpu_init();
+    int has_avx2 = __builtin_cpu_supports("avx2");
+    int has_sse2 = __builtin_cpu_supports("sse2");
+
+    if (force && strcmp(force, "scalar") == 0) return;
+    if (force && strcmp(force, "sse2") == 0) has_avx2 = 0;
+
+    if (has_avx2) {
+        ppu_decode_tile = decode_tile_avx2;
+        ppu_compose_span8 = compose_span8_avx2;
+        simd_name = "avx2";
+    } else if (has_sse2) {
+        ppu_decode_tile = decode_tile_sse2;
+        ppu_compose_span8 = compose_span8_sse2;
+        simd_name = "sse2";
+    }
+#else
+    (void)force;
+#endif
+}
+
+const char* ppu_simd_name(void) {
+    return simd_name;
+}
@@ -0,0 +1,283 @@
+// Profiler da CPU: só entra no build com -DNES_PROFILE (profile.h)
+#ifdef NES_PROFILE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "profile.h"
+#include "cpu.h"
+#include "log.h"
+
+#define PROFILE_MAX_NODES  16384      // pilhas distintas (nós da árvore de chamadas)
+#define PROFILE_MAX_DEPTH  64
+#define PROFILE_NODE_HASH  (1 << 15)  // filhos: (pai, tipo, endereço) -> nó
+#define PROFILE_LEAF_HASH  (1 << 17)  // folhas: (nó, opcode) -> ciclos
+#define PROFILE_TOP_PCS    50
+
+enum { FRAME_ROOT, FRAME_SUB, FRAME_NMI, FRAME_IRQ };
+
+static const char *mode_names[] = {
+    "imp", "acc", "imm", "zp", "zpx", "zpy", "rel",
+    "abs", "absx", "absy", "ind", "indx", "indy"
+};
+
+static const char *region_names[PROFILE_REGIONS] = {
+    "RAM ($0000-$1FFF)", "PPU ($2000-$3FFF)", "APU/IO ($4000-$401F)",
+    "Expansão ($4020-$5FFF)", "PRG-RAM ($6000-$7FFF)", "PRG ($8000-$FFFF)"
+};
+
+uint64_t profile_mem_access[2][PROFILE_REGIONS];
+
+// Por opcode e por PC
+static uint64_t op_count[256], op_cycles[256];
+static uint64_t pc_count[0x10000], pc_cycles[0x10000];
+static uint8_t  pc_opcode[0x10000];
+
+// Árvore de chamadas: cada nó é uma pilha (pai + quadro do topo)
+typedef struct {
+    uint32_t parent;
+    uint16_t addr;
+    uint8_t  kind;
+} profile_node_t;
+
+static profile_node_t nodes[PROFILE_MAX_NODES] = { { 0, 0, FRAME_ROOT } };
+static uint32_t node_count = 1;
+static uint32_t node_hash_key[PROFILE_NODE_HASH];   // 0 = vazio (chave + 1)
+static uint32_t node_hash_val[PROFILE_NODE_HASH];
+
+static uint32_t leaf_hash_key[PROFILE_LEAF_HASH];   // 0 = vazio (chave + 1)
+static uint64_t leaf_hash_cycles[PROFILE_LEAF_HASH];
+
+// Pilha sombra: nó de cada nível e o SP real logo depois do push
+static uint32_t stack_node[PROFILE_MAX_DEPTH + 1];
+static uint8_t  stack_sp[PROFILE_MAX_DEPTH + 1];
+static uint32_t current;      // nó da pilha atual (stack_node[depth])
+static int depth;
+static uint64_t lost_cycles;  // tabelas cheias
+
+static inline uint32_t hash32(uint32_t k) {
+    k ^= k >> 16;
+    k *= 0x7FEB352Du;
+    k ^= k >> 15;
+    return k;
+}
+
+// ======================
+// Pilha sombra
+// ======================
+
+// Descarta os quadros cujo endereço de retorno já saiu da pilha real
+// (SP acima do SP do push). Cobre RTS/RTI e também jogos que saem de
+// rotinas com PLA/PLA, TXS ou JMP, sem deixar a pilha sombra crescer.
+static void unwind(uint8_t sp) {
+    while (depth > 0 && sp > stack_sp[depth]) depth--;
+    current = stack_node[depth];
+}
+
+static void push_frame(int kind, uint16_t addr, uint8_t sp) {
+    unwind(sp);
+    if (depth >= PROFILE_MAX_DEPTH || node_count >= PROFILE_MAX_NODES) return;
+
+    uint32_t key = (current << 18 | (uint32_t)kind << 16 | addr) + 1;
+    uint32_t i = hash32(key) & (PROFILE_NODE_HASH - 1);
+    while (node_hash_key[i] && node_hash_key[i] != key) i = (i + 1) & (PROFILE_NODE_HASH - 1);
+
+    if (!node_hash_key[i]) {
+        node_hash_key[i] = key;
+        node_hash_val[i] = node_count;
+        nodes[node_count] = (profile_node_t){ current, addr, (uint8_t)kind };
+        node_count++;
+    }
+    depth++;
+    stack_node[depth] = current = node_hash_val[i];
+    stack_sp[depth] = sp;
+}
+
+static void add_leaf(uint8_t opcode, uint32_t cycles) {
+    uint32_t key = (current << 8 | opcode) + 1;
+    uint32_t i = hash32(key) & (PROFILE_LEAF_HASH - 1);
+    for (int probes = 0; probes < 64; probes++) {
+        if (leaf_hash_key[i] == key || !leaf_hash_key[i]) {
+            leaf_hash_key[i] = key;
+            leaf_hash_cycles[i] += cycles;
+            return;
+        }
+        i = (i + 1) & (PROFILE_LEAF_HASH - 1);
+    }
+    lost_cycles += cycles;
+}
+
+// ======================
+// Hooks
+// ======================
+void profile_instruction(uint16_t pc, uint8_t opcode, uint32_t cycles, uint16_t next_pc, uint8_t sp) {
+    op_count[opcode]++;
+    op_cycles[opcode] += cycles;
+    pc_count[pc]++;
+    pc_cycles[pc] += cycles;
+    pc_opcode[pc] = opcode;
+    add_leaf(opcode, cycles);
+
+    // Só instruções que mexem no SP podem desempilhar
+    switch (opcode) {
+        case 0x20: push_frame(FRAME_SUB, next_pc, sp); break;              // JSR
+        case 0x60: case 0x40: case 0x68: case 0x28: case 0x9A: unwind(sp); break;  // RTS RTI PLA PLP TXS
+    }
+}
+
+void profile_interrupt(int nmi, uint16_t handler, uint8_t sp) {
+    push_frame(nmi ? FRAME_NMI : FRAME_IRQ, handler, sp);
+}
+
+// ======================
+// Relatório
+// ======================
+static const uint64_t *sort_key;
+
+static int cmp_desc(const void *a, const void *b) {
+    uint64_t x = sort_key[*(const int *)a], y = sort_key[*(const int *)b];
+    return (x < y) - (x > y);
+}
+
+// Índices 0..n-1 ordenados por key decrescente
+static void sort_by(int *idx, int n, const uint64_t *key) {
+    for (int i = 0; i < n; i++) idx[i] = i;
+    sort_key = key;
+    qsort(idx, (size_t)n, sizeof(int), cmp_desc);
+}
+
+static void frame_name(const profile_node_t *n, char *out, size_t size) {
+    switch (n->kind) {
+        case FRAME_SUB: snprintf(out, size, "sub_%04X", n->addr); break;
+        case FRAME_NMI: snprintf(out, size, "NMI_%04X", n->addr); break;
+        case FRAME_IRQ: snprintf(out, size, "IRQ_%04X", n->addr); break;
+        default:        snprintf(out, size, "reset"); break;
+    }
+}
+
+static void write_report(FILE *f) {
+    static int idx[0x10000];
+    uint64_t total_count = 0, total_cycles = 0;
+    for (int i = 0; i < 256; i++) {
+        total_count += op_count[i];
+        total_cycles += op_cycles[i];
+    }
+    double pct = total_cycles ? 100.0 / (double)total_cycles : 0.0;
+
+    fprintf(f, "=== Perfil da CPU ===\n");
+    fprintf(f, "Instruções: %llu  Ciclos: %llu\n\n", (unsigned long long)total_count, (unsigned long long)total_cycles);
+
+    fprintf(f, "--- Opcodes (por ciclos) ---\n");
+    fprintf(f, "  op  instr modo    execuções        ciclos   %%ciclos  ciclos/instr\n");
+    sort_by(idx, 256, op_cycles);
+    for (int i = 0; i < 256 && op_count[idx[i]]; i++) {
+        int op = idx[i];
+        fprintf(f, "  %02X  %-5s %-5s %12llu  %12llu  %6.2f  %5.2f\n", op, instructions[op].name,
+                mode_names[instructions[op].mode], (unsigned long long)op_count[op],
+                (unsigned long long)op_cycles[op], op_cycles[op] * pct, (double)op_cycles[op] / op_count[op]);
+    }
+
+    uint64_t mode_count[13] = { 0 }, mode_cycles[13] = { 0 };
+    for (int op = 0; op < 256; op++) {
+        mode_count[instructions[op].mode] += op_count[op];
+        mode_cycles[instructions[op].mode] += op_cycles[op];
+    }
+    fprintf(f, "\n--- Modos de endereçamento ---\n");
+    sort_by(idx, 13, mode_cycles);
+    for (int i = 0; i < 13 && mode_count[idx[i]]; i++) {
+        int m = idx[i];
+        fprintf(f, "  %-5s %12llu execuções  %12llu ciclos  %6.2f%%\n", mode_names[m],
+                (unsigned long long)mode_count[m], (unsigned long long)mode_cycles[m], mode_cycles[m] * pct);
+    }
+
+    fprintf(f, "\n--- PCs mais quentes (top %d) ---\n", PROFILE_TOP_PCS);
+    sort_by(idx, 0x10000, pc_cycles);
+    for (int i = 0; i < PROFILE_TOP_PCS && pc_count[idx[i]]; i++) {
+        int pc = idx[i];
+        fprintf(f, "  $%04X  %-5s %-5s %12llu execuções  %12llu ciclos  %6.2f%%\n", pc,
+                instructions[pc_opcode[pc]].name, mode_names[instructions[pc_opcode[pc]].mode],
+                (unsigned long long)pc_count[pc], (unsigned long long)pc_cycles[pc], pc_cycles[pc] * pct);
+    }
+
+    // Ciclos próprios por rotina (quadro do topo da pilha), de todas as pilhas
+    static uint64_t routine_cycles[0x10000];
+    uint64_t root_cycles = 0;
+    memset(routine_cycles, 0, sizeof(routine_cycles));
+    for (int i = 0; i < PROFILE_LEAF_HASH; i++) {
+        if (!leaf_hash_key[i]) continue;
+        uint32_t node = (leaf_hash_key[i] - 1) >> 8;
+        if (node) routine_cycles[nodes[node].addr] += leaf_hash_cycles[i];
+        else root_cycles += leaf_hash_cycles[i];
+    }
+    fprintf(f, "\n--- Rotinas (ciclos próprios, top %d) ---\n", PROFILE_TOP_PCS);
+    fprintf(f, "  reset  %12llu ciclos  %6.2f%% (fora de JSR/interrupção)\n",
+            (unsigned long long)root_cycles, root_cycles * pct);
+    sort_by(idx, 0x10000, routine_cycles);
+    for (int i = 0; i < PROFILE_TOP_PCS && routine_cycles[idx[i]]; i++) {
+        fprintf(f, "  $%04X  %12llu ciclos  %6.2f%%\n", idx[i],
+                (unsigned long long)routine_cycles[idx[i]], routine_cycles[idx[i]] * pct);
+    }
+
+    fprintf(f, "\n--- Acessos à memória ---\n");
+    for (int r = 0; r < PROFILE_REGIONS; r++) {
+        fprintf(f, "  %-24s %12llu leituras  %12llu escritas\n", region_names[r],
+                (unsigned long long)profile_mem_access[0][r], (unsigned long long)profile_mem_access[1][r]);
+    }
+
+    if (lost_cycles || node_count >= PROFILE_MAX_NODES) {
+        fprintf(f, "\nAviso: tabelas de pilhas cheias (%llu ciclos fora do .folded)\n", (unsigned long long)lost_cycles);
+    }
+}
+
+// Uma linha por (pilha, opcode): "reset;sub_C0A3;LDA_abs 1234"
+static void write_folded(FILE *f) {
+    uint32_t chain[PROFILE_MAX_DEPTH + 1];
+    char name[16];
+
+    for (int i = 0; i < PROFILE_LEAF_HASH; i++) {
+        if (!leaf_hash_key[i]) continue;
+        uint32_t key = leaf_hash_key[i] - 1;
+        uint8_t opcode = key & 0xFF;
+
+        int n = 0;
+        for (uint32_t node = key >> 8; n <= PROFILE_MAX_DEPTH; node = nodes[node].parent) {
+            chain[n++] = node;
+            if (node == 0) break;
+        }
+        while (n-- > 0) {
+            frame_name(&nodes[chain[n]], name, sizeof(name));
+            fprintf(f, "%s;", name);
+        }
+        fprintf(f, "%s_%s %llu\n", instructions[opcode].name, mode_names[instructions[opcode].mode],
+                (unsigned long long)leaf_hash_cycles[i]);
+    }
+}
+
+int profile_write(const char *prefix) {
+    char path[512];
+    int ok = 1;
+
+    snprintf(path, sizeof(path), "%s.txt", prefix);
+    FILE *f = fopen(path, "w");
+    if (f) {
+        write_report(f);
+        fclose(f);
+    } else {
+        ok = 0;
+    }
+
+    snprintf(path, sizeof(path), "%s.folded", prefix);
+    f = fopen(path, "w");
+    if (f) {
+        write_folded(f);
+        fclose(f);
+    } else {
+        ok = 0;
+    }
+
+    if (ok) LOG_INFO(LOG_CPU, "Perfil gravado em %s.txt e %s.folded", prefix, prefix);
+    else LOG_ERROR(LOG_CPU, "Erro ao gravar o perfil (%s)", prefix);
+    return ok;
+}
+
+#endif
@@ -0,0 +1,221 @@
+#include <stdlib.h>
+#include <string.h>
+#include "rewind.h"
+#include "state.h"
+#include "log.h"
+
+// Literais terminam quando aparecem pelo menos tantos bytes iguais seguidos
+#define REWIND_MIN_RUN 4
+
+// ======================
+// XOR + RLE de zeros
+// ======================
+// Formato: sequência de [varint zeros][varint literais][literais], onde
+// zeros = bytes iguais à referência (pulados) e literais = cur ^ ref.
+
+static inline uint64_t load64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint8_t* put_varint(uint8_t *p, size_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static const uint8_t* get_varint(const uint8_t *p, size_t *v) {
+    size_t r = 0;
+    int shift = 0;
+    uint8_t b;
+    do {
+        b = *p++;
+        r |= (size_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+    *v = r;
+    return p;
+}
+
+static int same_run(const uint8_t *cur, const uint8_t *ref, size_t i, size_t n) {
+    if (i + REWIND_MIN_RUN > n) return 0;
+    for (int k = 0; k < REWIND_MIN_RUN; k++) {
+        if (cur[i + k] != ref[i + k]) return 0;
+    }
+    return 1;
+}
+
+// Retorna o tamanho codificado; out precisa de n + n / REWIND_MIN_RUN * 4 + 16
+static size_t xrle_encode(const uint8_t *cur, const uint8_t *ref, size_t n, uint8_t *out) {
+    uint8_t *p = out;
+    size_t i = 0;
+
+    while (i < n) {
+        // Trecho igual: 8 bytes por vez, depois byte a byte
+        size_t z = i;
+        while (z + 8 <= n && load64(cur + z) == load64(ref + z)) z += 8;
+        while (z < n && cur[z] == ref[z]) z++;
+        if (z == n) break;   // o resto é igual: o decoder já tem a referência
+
+        // Trecho diferente até uma sequência igual que compense cortar
+        size_t l = z + 1;
+        while (l < n && !same_run(cur, ref, l, n)) l++;
+
+        p = put_varint(p, z - i);
+        p = put_varint(p, l - z);
+        for (size_t k = z; k < l; k++) *p++ = cur[k] ^ ref[k];
+        i = l;
+    }
+    return (size_t)(p - out);
+}
+
+// Aplica o delta em out, que já contém a referência
+static void xrle_apply(const uint8_t *in, size_t len, uint8_t *out) {
+    const uint8_t *end = in + len;
+    size_t i = 0;
+
+    while (in < end) {
+        size_t zeros, literals;
+        in = get_varint(in, &zeros);
+        in = get_varint(in, &literals);
+        i += zeros;
+        for (size_t k = 0; k < literals; k++) out[i + k] ^= in[k];
+        in += literals;
+        i += literals;
+    }
+}
+
+// ======================
+// Ring
+// ======================
+static rewind_entry_t* entry_at(nes_rewind_t *rw, int n) {
+    return &rw->entries[(rw->first + n) % rw->capacity];
+}
+
+// Os bytes vivos vão do início da entrada mais antiga até write_pos
+static int overlaps_live(nes_rewind_t *rw, uint32_t pos, uint32_t len) {
+    if (!rw->count) return 0;
+    uint32_t start = entry_at(rw, 0)->offset;
+    uint32_t end = rw->write_pos;
+    if (start < end) return pos < end && start < pos + len;
+    return pos < end || pos + len > start;
+}
+
+// Tira a entrada mais antiga e os deltas que ficaram sem keyframe
+static void drop_oldest(nes_rewind_t *rw) {
+    do {
+        rw->first = (rw->first + 1) % rw->capacity;
+        rw->count--;
+    } while (rw->count && !entry_at(rw, 0)->key);
+}
+
+// Copia o bloco codificado para o ring; 0 = não entrou
+static int store(nes_rewind_t *rw, int key, uint32_t len) {
+    if (len > rw->data_size) return 0;
+
+    uint32_t pos = rw->write_pos;
+    if (pos + len > rw->data_size) pos = 0;
+
+    if (rw->count == rw->capacity) drop_oldest(rw);
+    while (overlaps_live(rw, pos, len)) drop_oldest(rw);
+
+    // Um delta precisa do keyframe dele ainda no ring
+    if (!key && !rw->count) return 0;
+
+    memcpy(rw->data + pos, rw->encoded, len);
+    *entry_at(rw, rw->count) = (rewind_entry_t){ pos, len, (uint8_t)key };
+    rw->count++;
+    rw->write_pos = pos + len;
+    return 1;
+}
+
+// ======================
+// API
+// ======================
+nes_rewind_t* rewind_init(nes_cpu_t *cpu, int seconds, size_t budget) {
+    nes_rewind_t *rw = calloc(1, sizeof(nes_rewind_t));
+    if (!rw) return NULL;
+
+    rw->state_size = state_size(cpu);
+    rw->capacity = seconds * 60;
+    rw->data_size = (uint32_t)budget;
+    rw->state = malloc(rw->state_size);
+    rw->key = calloc(1, rw->state_size);
+    rw->encoded = malloc(rw->state_size + rw->state_size / REWIND_MIN_RUN * 4 + 16);
+    rw->data = malloc(budget);
+    rw->entries = calloc((size_t)rw->capacity, sizeof(rewind_entry_t));
+    if (rw->capacity <= 0 || !rw->state || !rw->key || !rw->encoded || !rw->data || !rw->entries) {
+        LOG_ERROR(LOG_MMU, "Erro ao alocar rewind (%d s, %zu bytes)", seconds, budget);
+        rewind_free(rw);
+        return NULL;
+    }
+    rw->since_key = REWIND_KEY_INTERVAL;
+    return rw;
+}
+
+void rewind_free(nes_rewind_t *rw) {
+    if (!rw) return;
+    free(rw->state);
+    free(rw->key);
+    free(rw->encoded);
+    free(rw->data);
+    free(rw->entries);
+    free(rw);
+}
+
+void rewind_push(nes_rewind_t *rw, nes_cpu_t *cpu) {
+    state_save(cpu, rw->state, rw->state_size);
+
+    int key = rw->since_key >= REWIND_KEY_INTERVAL || !rw->count;
+    if (key) memset(rw->key, 0, rw->state_size);   // keyframe = XOR com zeros
+
+    uint32_t len = (uint32_t)xrle_encode(rw->state, rw->key, rw->state_size, rw->encoded);
+    if (!store(rw, key, len)) {
+        rw->since_key = REWIND_KEY_INTERVAL;        // tenta um keyframe no próximo
+        return;
+    }
+
+    if (key) {
+        memcpy(rw->key, rw->state, rw->state_size);
+        rw->since_key = 0;
+    }
+    rw->since_key++;
+}
+
+int rewind_pop(nes_rewind_t *rw, nes_cpu_t *cpu) {
+    if (!rw->count) return 0;
+
+    // Keyframe da entrada mais nova (sempre existe: o ring começa num)
+    int newest = rw->count - 1;
+    int k = newest;
+    while (!entry_at(rw, k)->key) k--;
+
+    rewind_entry_t *ke = entry_at(rw, k);
+    memset(rw->state, 0, rw->state_size);
+    xrle_apply(rw->data + ke->offset, ke->length, rw->state);
+    if (k != newest) {
+        rewind_entry_t *e = entry_at(rw, newest);
+        xrle_apply(rw->data + e->offset, e->length, rw->state);
+    }
+
+    // A entrada sai do ring; o próximo push recomeça com um keyframe
+    rw->write_pos = entry_at(rw, newest)->offset;
+    rw->count--;
+    rw->since_key = REWIND_KEY_INTERVAL;
+
+    return state_load(cpu, rw->state, rw->state_size);
+}
+
+int rewind_frames(nes_rewind_t *rw) {
+    return rw->count;
+}
+
+size_t rewind_bytes(nes_rewind_t *rw) {
+    size_t total = 0;
+    for (int i = 0; i < rw->count; i++) total += entry_at(rw, i)->length;
+    return total;
+}
@@ -0,0 +1,101 @@
+#include <string.h>
+#include "state.h"
+#include "memory.h"
+#include "log.h"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;         // tamanho total, cabeçalho incluído
+    uint16_t mapper;
+    uint16_t prg_banks;    // confere se é a mesma ROM
+} state_header_t;
+
+// Trecho contínuo de uma struct, do campo first ao last (inclusive)
+#define STATE_SPAN(type, first, last) \
+    (offsetof(type, last) + sizeof(((type *)0)->last) - offsetof(type, first))
+
+#define CPU_SPAN   STATE_SPAN(nes_cpu_t, a, irq_line)
+#define RAM_SPAN   STATE_SPAN(nes_memory_t, ram, prg_ram)
+#define PPU_SPAN   STATE_SPAN(nes_ppu_t, vram, cpu_time)
+#define APU_SPAN   STATE_SPAN(nes_apu_t, pulse, frame_start)
+
+size_t state_size(nes_cpu_t *cpu) {
+    return sizeof(state_header_t) + CPU_SPAN + RAM_SPAN + PPU_SPAN + APU_SPAN +
+           sizeof(nes_input_t) + cpu->memory->mapper->ctx_size;
+}
+
+// ======================
+// Save
+// ======================
+static uint8_t* put(uint8_t *p, const void *src, size_t n) {
+    memcpy(p, src, n);
+    return p + n;
+}
+
+size_t state_save(nes_cpu_t *cpu, uint8_t *buf, size_t capacity) {
+    nes_memory_t *mem = cpu->memory;
+    size_t size = state_size(cpu);
+    if (capacity < size) return 0;
+
+    state_header_t h = {
+        STATE_MAGIC, STATE_VERSION, (uint32_t)size,
+        (uint16_t)mem->mapper->number, (uint16_t)mem->rom->prg_rom_size
+    };
+
+    uint8_t *p = put(buf, &h, sizeof(h));
+    p = put(p, &cpu->a, CPU_SPAN);
+    p = put(p, mem->ram, RAM_SPAN);
+    p = put(p, mem->ppu->vram, PPU_SPAN);
+    p = put(p, mem->apu->pulse, APU_SPAN);
+    p = put(p, mem->input, sizeof(nes_input_t));
+    if (mem->mapper->ctx_size) put(p, mem->mapper->ctx, mem->mapper->ctx_size);
+    return size;
+}
+
+// ======================
+// Load
+// ======================
+static const uint8_t* get(const uint8_t *p, void *dst, size_t n) {
+    memcpy(dst, p, n);
+    return p + n;
+}
+
+int state_load(nes_cpu_t *cpu, const uint8_t *buf, size_t size) {
+    nes_memory_t *mem = cpu->memory;
+    nes_ppu_t *ppu = mem->ppu;
+    nes_apu_t *apu = mem->apu;
+    state_header_t h;
+
+    if (size < sizeof(h)) return 0;
+    memcpy(&h, buf, sizeof(h));
+    if (h.magic != STATE_MAGIC || h.version != STATE_VERSION || h.size != state_size(cpu) ||
+        size < h.size || h.mapper != mem->mapper->number || h.prg_banks != mem->rom->prg_rom_size) {
+        LOG_WARN(LOG_MMU, "Save state incompatível (versão %u, %u bytes)", h.version, h.size);
+        return 0;
+    }
+
+    int amp = apu->amp;
+
+    const uint8_t *p = buf + sizeof(h);
+    p = get(p, &cpu->a, CPU_SPAN);
+    p = get(p, mem->ram, RAM_SPAN);
+    p = get(p, ppu->vram, PPU_SPAN);
+    p = get(p, apu->pulse, APU_SPAN);
+    p = get(p, mem->input, sizeof(nes_input_t));
+    if (mem->mapper->ctx_size) get(p, mem->mapper->ctx, mem->mapper->ctx_size);
+
+    // O que é derivado (ponteiros) se refaz a partir do estado: páginas
+    // da CPU, janelas de CHR e espelhamento pelo mapper
+    memory_map_rebuild(mem);
+
+    // CHR-RAM voltou de outro momento: o cache de tiles não vale mais
+    if (ppu->chr_writable) memset(ppu->chr_dirty, 1, ppu->chr_size / 16);
+
+    // O blip buffer continua de onde estava; só o nível muda de uma vez
+    blip_add_delta(apu->blip, (uint32_t)(apu->cpu_time - apu->frame_start), apu->amp - amp);
+
+    // Previsões de evento do lote atual não valem mais
+    cpu_yield(cpu);
+    return 1;
+}
@@ -0,0 +1,407 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#include "video.h"
+#include "log.h"
+
+// ======================
+// API genérica
+// ======================
+int video_init(nes_video_sink_t *sink) {
+    if (!sink) return 0;
+    if (!sink->init) return 1;
+    return sink->init(sink);
+}
+
+void video_present(nes_video_sink_t *sink, const uint32_t *frame) {
+    if (sink && sink->present) sink->present(sink, frame);
+}
+
+int video_should_quit(nes_video_sink_t *sink) {
+    if (!sink || !sink->poll_quit) return 0;
+    return sink->poll_quit(sink);
+}
+
+uint8_t video_buttons(nes_video_sink_t *sink) {
+    if (!sink || !sink->buttons) return 0;
+    return sink->buttons(sink);
+}
+
+uint8_t video_hotkeys(nes_video_sink_t *sink) {
+    if (!sink || !sink->hotkeys) return 0;
+    return sink->hotkeys(sink);
+}
+
+void video_free(nes_video_sink_t *sink) {
+    if (!sink) return;
+    if (sink->shutdown) sink->shutdown(sink);
+    free(sink);
+}
+
+static nes_video_sink_t* sink_alloc(const char *name) {
+    nes_video_sink_t *sink = calloc(1, sizeof(nes_video_sink_t));
+    if (sink) sink->name = name;
+    return sink;
+}
+
+// ======================
+// Null: descarta os frames
+// ======================
+nes_video_sink_t* video_null_create(void) {
+    return sink_alloc("null");
+}
+
+// ======================
+// File: grava frames raw (ARGB8888 em sequência)
+// ======================
+typedef struct {
+    char *path;
+    FILE *file;
+} video_file_t;
+
+static int file_init(nes_video_sink_t *sink) {
+    video_file_t *vf = sink->ctx;
+    vf->file = fopen(vf->path, "wb");
+    if (!vf->file) {
+        LOG_ERROR(LOG_VIDEO, "Erro ao abrir %s", vf->path);
+        return 0;
+    }
+    return 1;
+}
+
+static void file_present(nes_video_sink_t *sink, const uint32_t *frame) {
+    video_file_t *vf = sink->ctx;
+    if (vf->file) fwrite(frame, 1, VIDEO_FRAME_BYTES, vf->file);
+}
+
+static void file_shutdown(nes_video_sink_t *sink) {
+    video_file_t *vf = sink->ctx;
+    if (vf->file) fclose(vf->file);
+    free(vf->path);
+    free(vf);
+}
+
+nes_video_sink_t* video_file_create(const char *path) {
+    nes_video_sink_t *sink = sink_alloc("file");
+    video_file_t *vf = calloc(1, sizeof(video_file_t));
+    if (!sink || !vf) {
+        free(sink);
+        free(vf);
+        return NULL;
+    }
+    vf->path = strdup(path);
+    sink->ctx = vf;
+    sink->init = file_init;
+    sink->present = file_present;
+    sink->shutdown = file_shutdown;
+    return sink;
+}
+
+// ======================
+// Shared memory: ring de frames para outro processo consumir
+// ======================
+#define VIDEO_SHM_MAGIC 0x4E455346  // "NESF"
+
+// Cabeçalho no início da região compartilhada. O leitor lê write_seq,
+// copia o slot (write_seq - 1) % slots e confere write_seq de novo.
+typedef struct {
+    uint32_t magic;
+    uint32_t width;
+    uint32_t height;
+    uint32_t slots;
+    _Atomic uint64_t write_seq;  // frames publicados até agora
+} video_shm_header_t;
+
+typedef struct {
+    char name[64];
+    int slots;
+    size_t size;
+    video_shm_header_t *header;
+    uint32_t *frames;
+#ifdef _WIN32
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+} video_shm_t;
+
+static int shm_init(nes_video_sink_t *sink) {
+    video_shm_t *vs = sink->ctx;
+    vs->size = sizeof(video_shm_header_t) + (size_t)vs->slots * VIDEO_FRAME_BYTES;
+
+#ifdef _WIN32
+    vs->mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+        0, (DWORD)vs->size, vs->name);
+    if (!vs->mapping) {
+        LOG_ERROR(LOG_VIDEO, "Erro ao criar memória compartilhada %s", vs->name);
+        return 0;
+    }
+    void *base = MapViewOfFile(vs->mapping, FILE_MAP_ALL_ACCESS, 0, 0, vs->size);
+    if (!base) {
+        CloseHandle(vs->mapping);
+        vs->mapping = NULL;
+        LOG_ERROR(LOG_VIDEO, "Erro ao mapear memória compartilhada %s", vs->name);
+        return 0;
+    }
+#else
+    vs->fd = shm_open(vs->name, O_CREAT | O_RDWR, 0600);
+    if (vs->fd < 0 || ftruncate(vs->fd, (off_t)vs->size) != 0) {
+        LOG_ERROR(LOG_VIDEO, "Erro ao criar memória compartilhada %s", vs->name);
+        if (vs->fd >= 0) close(vs->fd);
+        vs->fd = -1;
+        return 0;
+    }
+    void *base = mmap(NULL, vs->size, PROT_READ | PROT_WRITE, MAP_SHARED, vs->fd, 0);
+    if (base == MAP_FAILED) {
+        LOG_ERROR(LOG_VIDEO, "Erro ao mapear memória compartilhada %s", vs->name);
+        close(vs->fd);
+        vs->fd = -1;
+        return 0;
+    }
+#endif
+
+    vs->header = base;
+    vs->frames = (uint32_t *)((uint8_t *)base + sizeof(video_shm_header_t));
+    vs->header->magic = VIDEO_SHM_MAGIC;
+    vs->header->width = 256;
+    vs->header->height = 240;
+    vs->header->slots = (uint32_t)vs->slots;
+    atomic_store(&vs->header->write_seq, 0);
+    return 1;
+}
+
+static void shm_present(nes_video_sink_t *sink, const uint32_t *frame) {
+    video_shm_t *vs = sink->ctx;
+    if (!vs->header) return;
+
+    uint64_t seq = atomic_load_explicit(&vs->header->write_seq, memory_order_relaxed);
+    uint32_t *slot = vs->frames + (seq % (uint64_t)vs->slots) * VIDEO_FRAME_PIXELS;
+    memcpy(slot, frame, VIDEO_FRAME_BYTES);
+    atomic_store_explicit(&vs->header->write_seq, seq + 1, memory_order_release);
+}
+
+static void shm_shutdown(nes_video_sink_t *sink) {
+    video_shm_t *vs = sink->ctx;
+#ifdef _WIN32
+    if (vs->header) UnmapViewOfFile(vs->header);
+    if (vs->mapping) CloseHandle(vs->mapping);
+#else
+    if (vs->header) munmap(vs->header, vs->size);
+    if (vs->fd >= 0) {
+        close(vs->fd);
+        shm_unlink(vs->name);
+    }
+#endif
+    free(vs);
+}
+
+nes_video_sink_t* video_shm_create(const char *name, int slots) {
+    nes_video_sink_t *sink = sink_alloc("shm");
+    video_shm_t *vs = calloc(1, sizeof(video_shm_t));
+    if (!sink || !vs) {
+        free(sink);
+        free(vs);
+        return NULL;
+    }
+#ifdef _WIN32
+    snprintf(vs->name, sizeof(vs->name), "%s", name);
+#else
+    // shm_open exige nome começando com '/'
+    snprintf(vs->name, sizeof(vs->name), "%s%s", name[0] == '/' ? "" : "/", name);
+    vs->fd = -1;
+#endif
+    vs->slots = slots > 0 ? slots : 4;
+    sink->ctx = vs;
+    sink->init = shm_init;
+    sink->present = shm_present;
+    sink->shutdown = shm_shutdown;
+    return sink;
+}
+
+// ======================
+// Threaded: apresentação fora da thread de emulação
+// ======================
+// Triple buffer: a emulação escreve em back, publica trocando com ready
+// (marcado como novo) e segue. A thread de apresentação troca front com
+// ready quando há frame novo. Ninguém espera ninguém; se a apresentação
+// atrasar, frames intermediários são simplesmente substituídos.
+#define READY_NEW 0x4
+
+typedef struct {
+    nes_video_sink_t *inner;
+    uint32_t *buffers[3];
+    int back;                 // só a thread de emulação mexe
+    int front;                // só a thread de apresentação mexe
+    _Atomic int ready;        // índice | READY_NEW
+    _Atomic int quit;         // pedido de saída vindo do backend
+    _Atomic int buttons;      // teclado lido pela thread do backend
+    _Atomic int hotkeys;
+    _Atomic int running;
+    _Atomic int init_result;  // 0 = pendente, 1 = ok, -1 = falhou
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+} video_threaded_t;
+
+// Encerra o backend sem liberar a struct (fica para threaded_shutdown);
+// se a thread nunca rodou, o shutdown dele fica para a thread principal,
+// que então é a mesma que o criou
+static void threaded_inner_shutdown(nes_video_sink_t *inner) {
+    if (inner->shutdown) inner->shutdown(inner);
+    inner->shutdown = NULL;
+}
+
+static void* threaded_main(void *arg) {
+    nes_video_sink_t *sink = arg;
+    video_threaded_t *vt = sink->ctx;
+
+    // O backend é inicializado e encerrado na própria thread (SDL exige
+    // que janela e renderer sejam usados na thread que os criou)
+    if (!video_init(vt->inner)) {
+        threaded_inner_shutdown(vt->inner);
+        atomic_store(&vt->init_result, -1);
+        return NULL;
+    }
+    atomic_store(&vt->init_result, 1);
+
+    while (atomic_load(&vt->running)) {
+        pthread_mutex_lock(&vt->lock);
+        while (atomic_load(&vt->running) && !(atomic_load(&vt->ready) & READY_NEW)) {
+            pthread_cond_wait(&vt->wake, &vt->lock);
+        }
+        pthread_mutex_unlock(&vt->lock);
+        if (!atomic_load(&vt->running)) break;
+
+        vt->front = atomic_exchange(&vt->ready, vt->front) & 3;
+        video_present(vt->inner, vt->buffers[vt->front]);
+        if (video_should_quit(vt->inner)) atomic_store(&vt->quit, 1);
+        atomic_store(&vt->buttons, video_buttons(vt->inner));
+        atomic_store(&vt->hotkeys, video_hotkeys(vt->inner));
+    }
+    threaded_inner_shutdown(vt->inner);
+    return NULL;
+}
+
+static int threaded_init(nes_video_sink_t *sink) {
+    video_threaded_t *vt = sink->ctx;
+    atomic_store(&vt->running, 1);
+    if (pthread_create(&vt->thread, NULL, threaded_main, sink) != 0) {
+        LOG_ERROR(LOG_VIDEO, "Erro ao criar thread de apresentação");
+        atomic_store(&vt->running, 0);
+        return 0;
+    }
+
+    // Espera o backend terminar de inicializar para reportar erro cedo
+    while (atomic_load(&vt->init_result) == 0) {
+#ifdef _WIN32
+        Sleep(1);
+#else
+        usleep(1000);
+#endif
+    }
+    if (atomic_load(&vt->init_result) < 0) {
+        pthread_join(vt->thread, NULL);
+        atomic_store(&vt->running, 0);
+        return 0;
+    }
+    return 1;
+}
+
+static void threaded_present(nes_video_sink_t *sink, const uint32_t *frame) {
+    video_threaded_t *vt = sink->ctx;
+    memcpy(vt->buffers[vt->back], frame, VIDEO_FRAME_BYTES);
+    vt->back = atomic_exchange(&vt->ready, vt->back | READY_NEW) & 3;
+
+    pthread_mutex_lock(&vt->lock);
+    pthread_cond_signal(&vt->wake);
+    pthread_mutex_unlock(&vt->lock);
+}
+
+static int threaded_poll_quit(nes_video_sink_t *sink) {
+    video_threaded_t *vt = sink->ctx;
+    return atomic_load(&vt->quit);
+}
+
+static uint8_t threaded_buttons(nes_video_sink_t *sink) {
+    video_threaded_t *vt = sink->ctx;
+    return (uint8_t)atomic_load(&vt->buttons);
+}
+
+static uint8_t threaded_hotkeys(nes_video_sink_t *sink) {
+    video_threaded_t *vt = sink->ctx;
+    return (uint8_t)atomic_load(&vt->hotkeys);
+}
+
+static void threaded_shutdown(nes_video_sink_t *sink) {
+    video_threaded_t *vt = sink->ctx;
+    if (atomic_load(&vt->running)) {
+        pthread_mutex_lock(&vt->lock);
+        atomic_store(&vt->running, 0);
+        pthread_cond_signal(&vt->wake);
+        pthread_mutex_unlock(&vt->lock);
+        pthread_join(vt->thread, NULL);
+    }
+    video_free(vt->inner);   // backend já encerrado pela thread de apresentação
+    pthread_mutex_destroy(&vt->lock);
+    pthread_cond_destroy(&vt->wake);
+    for (int i = 0; i < 3; i++) free(vt->buffers[i]);
+    free(vt);
+}
+
+nes_video_sink_t* video_threaded_create(nes_video_sink_t *inner) {
+    if (!inner) return NULL;
+    nes_video_sink_t *sink = sink_alloc("threaded");
+    video_threaded_t *vt = calloc(1, sizeof(video_threaded_t));
+    if (!sink || !vt) {
+        free(sink);
+        free(vt);
+        return NULL;
+    }
+    for (int i = 0; i < 3; i++) {
+        vt->buffers[i] = calloc(VIDEO_FRAME_PIXELS, sizeof(uint32_t));
+        if (!vt->buffers[i]) {
+            while (i-- > 0) free(vt->buffers[i]);
+            free(sink);
+            free(vt);
+            return NULL;
+        }
+    }
+    vt->inner = inner;
+    vt->back = 0;
+    vt->ready = 1;
+    vt->front = 2;
+    pthread_mutex_init(&vt->lock, NULL);
+    pthread_cond_init(&vt->wake, NULL);
+
+    sink->ctx = vt;
+    sink->init = threaded_init;
+    sink->present = threaded_present;
+    sink->poll_quit = threaded_poll_quit;
+    sink->buttons = threaded_buttons;
+    sink->hotkeys = threaded_hotkeys;
+    sink->shutdown = threaded_shutdown;
+    return sink;
+}
+
+// ======================
+// Seleção por string (linha de comando)
+// ======================
+nes_video_sink_t* video_create(const char *spec) {
+    if (strcmp(spec, "null") == 0) return video_null_create();
+    if (strncmp(spec, "file:", 5) == 0) return video_file_create(spec + 5);
+    if (strncmp(spec, "shm:", 4) == 0) return video_shm_create(spec + 4, 4);
+#ifndef NES_HEADLESS
+    if (strcmp(spec, "sdl") == 0) return video_sdl_create(3);
+#endif
+    LOG_ERROR(LOG_VIDEO, "Backend desconhecido: %s", spec);
+    return NULL;
+}
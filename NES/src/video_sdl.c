@@ -0,0 +1,148 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "video.h"
+#include "ppu.h"
+#include "input.h"
+#include "log.h"
+
+// Estado do backend SDL
+typedef struct {
+    int scale;
+    SDL_Window   *window;
+    SDL_Renderer *renderer;
+    SDL_Texture  *texture;
+} video_sdl_t;
+
+static int sdl_init(nes_video_sink_t *sink) {
+    video_sdl_t *vs = sink->ctx;
+
+    // Inicializa SDL
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        LOG_ERROR(LOG_VIDEO, "Erro ao inicializar SDL: %s", SDL_GetError());
+        return 0;
+    }
+
+    vs->window = SDL_CreateWindow("NES Emulator - PPU",
+        SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+        NES_SCREEN_WIDTH * vs->scale, NES_SCREEN_HEIGHT * vs->scale,
+        0);
+
+    if (!vs->window) {
+        LOG_ERROR(LOG_VIDEO, "Erro ao criar janela: %s", SDL_GetError());
+        SDL_Quit();
+        return 0;
+    }
+
+    vs->renderer = SDL_CreateRenderer(vs->window, -1, SDL_RENDERER_ACCELERATED);
+    if (!vs->renderer) {
+        LOG_ERROR(LOG_VIDEO, "Erro ao criar renderer: %s", SDL_GetError());
+        SDL_DestroyWindow(vs->window);
+        vs->window = NULL;
+        SDL_Quit();
+        return 0;
+    }
+
+    vs->texture = SDL_CreateTexture(vs->renderer, SDL_PIXELFORMAT_ARGB8888,
+        SDL_TEXTUREACCESS_STREAMING,
+        NES_SCREEN_WIDTH, NES_SCREEN_HEIGHT);
+
+    if (!vs->texture) {
+        LOG_ERROR(LOG_VIDEO, "Erro ao criar texture: %s", SDL_GetError());
+        SDL_DestroyRenderer(vs->renderer);
+        SDL_DestroyWindow(vs->window);
+        vs->renderer = NULL;
+        vs->window = NULL;
+        SDL_Quit();
+        return 0;
+    }
+
+    return 1;
+}
+
+static void sdl_present(nes_video_sink_t *sink, const uint32_t *frame) {
+    video_sdl_t *vs = sink->ctx;
+    if (!vs->texture) return;
+
+    if (SDL_UpdateTexture(vs->texture, NULL, frame, NES_SCREEN_WIDTH * sizeof(uint32_t)) != 0) {
+        LOG_ERROR(LOG_VIDEO, "SDL_UpdateTexture: %s", SDL_GetError());
+        return;
+    }
+
+    if (SDL_RenderClear(vs->renderer) != 0) {
+        LOG_ERROR(LOG_VIDEO, "SDL_RenderClear: %s", SDL_GetError());
+        return;
+    }
+
+    if (SDL_RenderCopy(vs->renderer, vs->texture, NULL, NULL) != 0) {
+        LOG_ERROR(LOG_VIDEO, "SDL_RenderCopy: %s", SDL_GetError());
+        return;
+    }
+
+    SDL_RenderPresent(vs->renderer);
+}
+
+// Eventos da janela (precisa rodar na thread que criou a janela)
+static int sdl_poll_quit(nes_video_sink_t *sink) {
+    SDL_Event event;
+    int quit = 0;
+    while (SDL_PollEvent(&event)) {
+        if (event.type == SDL_QUIT) quit = 1;
+    }
+    return quit;
+}
+
+// Teclado → controle 1: setas, Z = B, X = A, Backspace/RShift = Select,
+// Enter = Start. Usa o estado que o SDL_PollEvent do poll_quit atualizou.
+static uint8_t sdl_buttons(nes_video_sink_t *sink) {
+    (void)sink;
+    const Uint8 *keys = SDL_GetKeyboardState(NULL);
+    uint8_t buttons = 0;
+    if (keys[SDL_SCANCODE_X]) buttons |= INPUT_A;
+    if (keys[SDL_SCANCODE_Z]) buttons |= INPUT_B;
+    if (keys[SDL_SCANCODE_BACKSPACE] || keys[SDL_SCANCODE_RSHIFT]) buttons |= INPUT_SELECT;
+    if (keys[SDL_SCANCODE_RETURN]) buttons |= INPUT_START;
+    if (keys[SDL_SCANCODE_UP]) buttons |= INPUT_UP;
+    if (keys[SDL_SCANCODE_DOWN]) buttons |= INPUT_DOWN;
+    if (keys[SDL_SCANCODE_LEFT]) buttons |= INPUT_LEFT;
+    if (keys[SDL_SCANCODE_RIGHT]) buttons |= INPUT_RIGHT;
+    return buttons;
+}
+
+// R segurado = rewind
+static uint8_t sdl_hotkeys(nes_video_sink_t *sink) {
+    (void)sink;
+    const Uint8 *keys = SDL_GetKeyboardState(NULL);
+    return keys[SDL_SCANCODE_R] ? VIDEO_HOTKEY_REWIND : 0;
+}
+
+static void sdl_shutdown(nes_video_sink_t *sink) {
+    video_sdl_t *vs = sink->ctx;
+    if (vs->texture) SDL_DestroyTexture(vs->texture);
+    if (vs->renderer) SDL_DestroyRenderer(vs->renderer);
+    if (vs->window) {
+        SDL_DestroyWindow(vs->window);
+        SDL_Quit();
+    }
+    free(vs);
+}
+
+nes_video_sink_t* video_sdl_create(int scale) {
+    nes_video_sink_t *sink = calloc(1, sizeof(nes_video_sink_t));
+    video_sdl_t *vs = calloc(1, sizeof(video_sdl_t));
+    if (!sink || !vs) {
+        free(sink);
+        free(vs);
+        return NULL;
+    }
+    vs->scale = scale > 0 ? scale : 1;
+    sink->name = "sdl";
+    sink->ctx = vs;
+    sink->init = sdl_init;
+    sink->present = sdl_present;
+    sink->poll_quit = sdl_poll_quit;
+    sink->buttons = sdl_buttons;
+    sink->hotkeys = sdl_hotkeys;
+    sink->shutdown = sdl_shutdown;
+    return sink;
+}